@@ -0,0 +1,108 @@
+/**
+ * @file:   AdaptiveInterval.cpp
+ * @class:  AdaptiveInterval
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Adaptive interval of the pump cycle
+ *          Short on fast changes & near the alarms, long when flat
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "AdaptiveInterval.h"
+#include <stdlib.h>
+
+using namespace std;
+
+
+
+/* The constructor takes the bounds & levels of the configuration
+ */
+AdaptiveInterval::AdaptiveInterval(config cfg)
+{
+    Min = cfg.schedMinMs;
+    Max = cfg.schedMaxMs;
+    FastRate = cfg.adaptRate;
+    UpperLimit = cfg.upperLimit;
+    LowerLimit = cfg.lowerLimit;
+    UpperAlarm = cfg.upperAlarm;
+    LowerAlarm = cfg.lowerAlarm;
+    BattWarn = cfg.battWarn;
+    Level = -1;
+    SinceChange = 0;
+    Rate = 0;
+
+    setBase(cfg.schedIntMs);
+}
+
+
+/* Safety first: fast changes & alarms, dosing, then battery & flat
+ */
+int AdaptiveInterval::next(int bsl, int intervalMs, int battery)
+{
+    int base = Base;
+
+    // an unchanged reading is flat only after a whole base interval
+    SinceChange += intervalMs;
+    if(bsl != Level)
+    {
+        Rate = Level < 0 ? 0 : (long)abs(bsl - Level) * base / (SinceChange > 0 ? SinceChange : 1);
+        Level = bsl;
+        SinceChange = 0;
+    }
+    else if(SinceChange >= base)
+    {
+        Rate = 0;
+    }
+
+    if(Rate >= FastRate ||
+       bsl >= UpperAlarm - ADAPTIVE_ALARM_MARGIN ||
+       bsl <= LowerAlarm + ADAPTIVE_ALARM_MARGIN)
+    {
+        return Min;
+    }
+    // no longer intervals while the pump doses
+    if(bsl > UpperLimit || bsl < LowerLimit)
+    {
+        return base;
+    }
+    if(battery <= BattWarn + ADAPTIVE_BATTERY_MARGIN)
+    {
+        return Max;
+    }
+    if(Rate * ADAPTIVE_FLAT_DIVISOR < FastRate)
+    {
+        return intervalMs < Max / 2 ? intervalMs * 2 : Max;
+    }
+
+    return base;
+}
+
+
+/* Getter & Setter for the base interval
+ */
+int AdaptiveInterval::getBase() const
+{
+    return Base;
+}
+
+void AdaptiveInterval::setBase(int milliseconds)
+{
+    Base = milliseconds < Min ? Min : milliseconds > Max ? Max : milliseconds;
+}
+
+/* Getter for the bounds
+ */
+int AdaptiveInterval::getMin() const
+{
+    return Min;
+}
+
+int AdaptiveInterval::getMax() const
+{
+    return Max;
+}
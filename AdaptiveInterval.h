@@ -0,0 +1,109 @@
+/**
+ * @file:   AdaptiveInterval.h
+ * @class:  AdaptiveInterval
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Adaptive interval of the pump cycle
+ *          Short on fast changes & near the alarms, long when flat
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef adaptiveinterval_
+#define adaptiveinterval_
+
+#include <atomic>
+#include "Config.h"
+
+
+#define ADAPTIVE_MIN_DIVISOR    4       // SchedMinMs if not given: SchedIntMs / 4
+#define ADAPTIVE_MAX_FACTOR     4       // SchedMaxMs if not given: SchedIntMs * 4
+#define ADAPTIVE_RATE           5       // AdaptRate if not given, mg/dL per interval
+#define ADAPTIVE_FLAT_DIVISOR   4       // flat: below a quarter of AdaptRate
+#define ADAPTIVE_ALARM_MARGIN   20      // near the alarms: closer than 20 mg/dL
+#define ADAPTIVE_BATTERY_MARGIN 10      // near BattWarn: at most 10 % above
+
+
+
+class AdaptiveInterval
+{
+    public:
+        /**
+         * @name:   Adaptive Interval
+         * @brief:  Adaptive Interval Constructor
+         *
+         *  Takes the bounds, the fast rate, the alarms and the battery
+         *  warning level of the configuration, SchedIntMs is the base
+         *
+         * @param:  The configuration
+         */
+        AdaptiveInterval(config cfg);
+
+        /**
+         * @name:   Next
+         * @brief:  The interval until the next pump cycle
+         *
+         *  The rate is the change of the BSL since it last changed, scaled
+         *  to the base interval, so sampling faster than the sensor updates
+         *  does not look flat. Fast changes or a BSL near an alarm give the
+         *  shortest interval, whatever the battery. Outside the limits, while
+         *  the pump doses, it is the base interval. Within them a battery
+         *  near the warning level gives the longest one, a flat BSL doubles
+         *  the interval up to the longest and everything else returns to the
+         *  base interval. Only called by the pump cycle.
+         *
+         * @param:  The blood sugar level of the last cycle in mg/dL
+         * @param:  The interval since the cycle before in milliseconds
+         * @param:  The battery load level in percent
+         * @return: The next interval in milliseconds
+         */
+        int next(int bsl, int intervalMs, int battery);
+
+        /**
+         * @name:   Get/Set Base
+         * @brief:  Get/Set the interval of moderate changes
+         *
+         *  Set when the user changes the interval, kept within the bounds.
+         *  Safe to call while another thread asks for the next interval.
+         *
+         * @param:  The base interval in milliseconds
+         * @return: The base interval in milliseconds
+         */
+        int getBase() const;
+        void setBase(int milliseconds);
+
+        /**
+         * @name:   Get Min/Max
+         * @brief:  The bounds of the interval
+         *
+         * @return: The shortest/longest interval in milliseconds
+         */
+        int getMin() const;
+        int getMax() const;
+
+    private:
+        std::atomic<int> Base;
+        int Min;
+        int Max;
+        int FastRate;
+        int UpperLimit;
+        int LowerLimit;
+        int UpperAlarm;
+        int LowerAlarm;
+        int BattWarn;
+
+        /**
+         * @name:   Level / Since Change / Rate
+         * @brief:  The last BSL, the time since it changed and the
+         *          last rate in mg/dL per base interval, -1: none yet
+         */
+        int Level;
+        long SinceChange;
+        long Rate;
+};
+
+#endif
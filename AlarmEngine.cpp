@@ -0,0 +1,184 @@
+/**
+ * @file:   AlarmEngine.cpp
+ * @class:  AlarmEngine
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Alarms of the health checks as state machines
+ *          Notifies on transitions only, with hysteresis & snooze
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "AlarmEngine.h"
+
+using namespace std;
+
+
+
+/* The constructor starts without alarms
+ */
+AlarmEngine::AlarmEngine(Tracer *tracer, Clock *clock) :
+    Notified(0),
+    Suppressed(0),
+    TheTracer(tracer),
+    TheClock(clock ? clock : Clock::getRealClock())
+{
+}
+
+
+/* Registers an alarm, low alarms are stored negated
+ */
+int AlarmEngine::addAlarm(QString name, bool high, int warning, int critical, int hysteresis,
+                          QString warningText, QString criticalText, bool signalled)
+{
+    alarmentry entry;
+    entry.name = name;
+    entry.high = high;
+    entry.warning = high ? warning : -warning;
+    entry.critical = high ? critical : -critical;
+    entry.hysteresis = hysteresis > 0 ? hysteresis : 0;
+    entry.warningText = warningText;
+    entry.criticalText = criticalText;
+    entry.signalled = signalled;
+    entry.state = ALARM_NONE;
+
+    lock_guard<mutex> lock(Lock);
+    Alarms.push_back(entry);
+
+    return Alarms.size() - 1;
+}
+
+/* New levels, the state follows with the next value
+ */
+void AlarmEngine::setLevels(int alarm, int warning, int critical)
+{
+    lock_guard<mutex> lock(Lock);
+
+    alarmentry &entry = Alarms[alarm];
+    entry.warning = entry.high ? warning : -warning;
+    entry.critical = entry.high ? critical : -critical;
+}
+
+
+/* Raises at the levels, lowers only past level & hysteresis
+ */
+int AlarmEngine::update(int alarm, int value)
+{
+    unique_lock<mutex> lock(Lock);
+
+    alarmentry &entry = Alarms[alarm];
+    int level = entry.high ? value : -value;
+    int state;
+    if(level >= entry.critical ||
+       (entry.state == ALARM_CRITICAL && level > entry.critical - entry.hysteresis))
+    {
+        state = ALARM_CRITICAL;
+    }
+    else if(level >= entry.warning ||
+            (entry.state >= ALARM_WARNING && level > entry.warning - entry.hysteresis))
+    {
+        state = ALARM_WARNING;
+    }
+    else
+    {
+        state = ALARM_NONE;
+    }
+
+    chrono::steady_clock::time_point now = TheClock->now();
+    int previous = entry.state;
+    bool repeated = state == previous && state != ALARM_NONE && now >= entry.snoozed;
+    if(state == previous && !repeated)
+    {
+        if(state != ALARM_NONE)
+        {
+            Suppressed++;
+        }
+        return state;
+    }
+
+    entry.state = state;
+    entry.snoozed = now + chrono::milliseconds(state == ALARM_CRITICAL ? ALARM_SNOOZE_CRITICAL_MS
+                                                                       : ALARM_SNOOZE_WARNING_MS);
+    Notified++;
+    alarmentry notified = entry;
+    lock.unlock();
+
+    // written unlocked, the tracer may take its time
+    if(state > previous || repeated)
+    {
+        notify(notified, value, repeated);
+    }
+    else if(state == ALARM_WARNING)
+    {
+        TheTracer->writeStatusLog("The " + notified.name + " alarm is lowered to a warning (" +
+                                  QString::number(value) + ").");
+    }
+    else
+    {
+        TheTracer->writeStatusLog("The " + notified.name + " alarm is cleared (" +
+                                  QString::number(value) + ").");
+    }
+
+    return state;
+}
+
+/* Getter for the state of an alarm
+ */
+int AlarmEngine::getState(int alarm)
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Alarms[alarm].state;
+}
+
+/* Getter for the counters
+ */
+uint64_t AlarmEngine::getNotified()
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Notified;
+}
+
+uint64_t AlarmEngine::getSuppressed()
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Suppressed;
+}
+
+
+/* Warning log, or critical log with beep & vibration
+ */
+void AlarmEngine::notify(const alarmentry &entry, int value, bool repeated)
+{
+    QString prefix = repeated ? "Still: " : "";
+    int critical = entry.high ? entry.critical : -entry.critical;
+
+    // replaced by number, a text may leave out any of them
+    if(entry.state == ALARM_CRITICAL)
+    {
+        QString text = entry.criticalText;
+        text.replace("%1", QString::number(value))
+            .replace("%2", QString::number(critical))
+            .replace("%3", QString::number(critical));
+        TheTracer->writeCriticalLog(prefix + text);
+        if(entry.signalled)
+        {
+            TheTracer->playAcousticWarning();
+            TheTracer->vibrationWarning();
+        }
+    }
+    else
+    {
+        QString text = entry.warningText;
+        text.replace("%1", QString::number(value))
+            .replace("%2", QString::number(entry.high ? entry.warning : -entry.warning))
+            .replace("%3", QString::number(critical));
+        TheTracer->writeWarningLog(prefix + text);
+    }
+}
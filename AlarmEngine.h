@@ -0,0 +1,166 @@
+/**
+ * @file:   AlarmEngine.h
+ * @class:  AlarmEngine
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Alarms of the health checks as state machines
+ *          Notifies on transitions only, with hysteresis & snooze
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef alarmengine_
+#define alarmengine_
+
+#include <QString>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+#include "Clock.h"
+#include "Tracer.h"
+
+
+#define ALARM_NONE          0
+#define ALARM_WARNING       1
+#define ALARM_CRITICAL      2
+
+#define ALARM_SNOOZE_WARNING_MS     3600000     // a lasting warning is repeated after 1 h
+#define ALARM_SNOOZE_CRITICAL_MS    900000      // a lasting critical alarm is repeated after 15 min
+
+
+
+class AlarmEngine
+{
+    public:
+        /**
+         * @name:   Alarm Engine
+         * @brief:  Alarm Engine Constructor
+         *
+         * @param:  The tracer the notifications go to
+         * @param:  The clock of the snooze, NULL for the real clock
+         */
+        AlarmEngine(Tracer *tracer, Clock *clock = NULL);
+
+        /**
+         * @name:   Add Alarm
+         * @brief:  Registers an alarm, starting without alarm
+         *
+         *  A high alarm is raised when the value reaches the levels from
+         *  below, a low one from above. The warning level equal to the
+         *  critical one gives an alarm without warning. An alarm is only
+         *  lowered when the value is back past its level by the hysteresis.
+         *  The texts get the value as %1, the level reached as %2 and
+         *  the critical level as %3.
+         *
+         * @param:  The name of the alarm, for the lowered & cleared notes
+         * @param:  'true' for a high alarm, 'false' for a low one
+         * @param:  The warning level
+         * @param:  The critical level
+         * @param:  The hysteresis, in the unit of the value
+         * @param:  The text of the warning
+         * @param:  The text of the critical alarm
+         * @param:  'false' for a critical alarm that is only logged,
+         *          without beep & vibration
+         * @return: The number of the alarm
+         */
+        int addAlarm(QString name, bool high, int warning, int critical, int hysteresis,
+                     QString warningText, QString criticalText, bool signalled = true);
+
+        /**
+         * @name:   Set Levels
+         * @brief:  Sets new levels of an alarm, from the next update
+         *
+         * @param:  The number of the alarm
+         * @param:  The warning level
+         * @param:  The critical level
+         */
+        void setLevels(int alarm, int warning, int critical);
+
+        /**
+         * @name:   Update
+         * @brief:  Feeds a new value to an alarm
+         *
+         *  Notifies on raising (warning log, or critical log, beep and
+         *  vibration if signalled), writes a status log on lowering or clearing and
+         *  otherwise stays silent. A lasting alarm is notified again when
+         *  its snooze (ALARM_SNOOZE_*_MS) ran out. Safe to call from
+         *  any thread.
+         *
+         * @param:  The number of the alarm
+         * @param:  The value
+         * @return: The new state, ALARM_*
+         */
+        int update(int alarm, int value);
+
+        /**
+         * @name:   Get State
+         * @brief:  The state of an alarm after its last update
+         *
+         * @param:  The number of the alarm
+         * @return: ALARM_*
+         */
+        int getState(int alarm);
+
+        /**
+         * @name:   Get Notified / Suppressed
+         * @brief:  Counters of all alarms
+         *
+         * @return: Updates that notified or wrote a status log /
+         *          updates of a raised alarm that stayed silent
+         */
+        uint64_t getNotified();
+        uint64_t getSuppressed();
+
+    private:
+        /**
+         * @name:   Alarm
+         * @brief:  A registered alarm and its state, the levels &
+         *          values are negated for low alarms
+         */
+        struct alarmentry{
+            QString name;
+            bool high;
+            int warning;
+            int critical;
+            int hysteresis;
+            QString warningText;
+            QString criticalText;
+            bool signalled;
+            int state;
+            std::chrono::steady_clock::time_point snoozed;   // silent until
+        };
+
+        std::vector<alarmentry> Alarms;
+
+        /**
+         * @name:   Lock / Counters
+         * @brief:  Protects the alarms / see getNotified()
+         */
+        std::mutex Lock;
+        uint64_t Notified;
+        uint64_t Suppressed;
+
+        /**
+         * @name:   The Tracer & The Clock
+         * @brief:  Destination of the notifications, time of the snooze
+         */
+        Tracer *TheTracer;
+        Clock *TheClock;
+
+        /**
+         * @name:   Notify
+         * @brief:  Writes the notification of a raised alarm
+         *
+         * @param:  The alarm
+         * @param:  The value, not negated
+         * @param:  'true' when the alarm is repeated after its snooze
+         */
+        void notify(const alarmentry &entry, int value, bool repeated);
+};
+
+#endif
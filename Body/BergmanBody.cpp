@@ -0,0 +1,132 @@
+//
+//
+//  BergmanBody.cpp
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Body with continuous glucose/insulin/glucagon compartments (Bergman minimal model)
+//               integrated by a fixed step RK4 solver, one iteration still is 0.5 hours.
+//
+
+#include "BergmanBody.h"
+#include <math.h>
+
+/****************************************************************
+ *                     Class: BergmanBody                       *
+ ****************************************************************/
+
+// constructor
+BergmanBody::BergmanBody(float BSL, double step_minutes) : Body(BSL, 0, 0) {
+    BasalGlucose = BSL;
+    State.G = BSL;
+    State.X = 0;
+    State.I = BERGMAN_BASAL_INSULIN;
+    State.Y = 0;
+    setStepMinutes(step_minutes);
+}
+
+// destructor
+BergmanBody::~BergmanBody(){
+
+}
+
+/******************************************************
+ *   the model:                                       *
+ *      dG/dt = -(p1 + X) G + p1 Gb + d G + gg Y      *
+ *      dX/dt = -p2 X + p3 (I - Ib)                   *
+ *      dI/dt = -n (I - Ib) + insulin infusion        *
+ *      dY/dt = -ky Y + glucagon infusion             *
+ ******************************************************/
+void BergmanBody::derivatives(const bergmanstate &s, double disturbance, double insulin_rate,
+                              double glucagon_rate, bergmanstate &d) {
+    d.G = -(BERGMAN_P1 + s.X) * s.G + BERGMAN_P1 * BasalGlucose
+          + disturbance * s.G + BERGMAN_GLUCAGON_GAIN * s.Y;
+    d.X = -BERGMAN_P2 * s.X + BERGMAN_P3 * (s.I - BERGMAN_BASAL_INSULIN);
+    d.I = -BERGMAN_N * (s.I - BERGMAN_BASAL_INSULIN) + insulin_rate;
+    d.Y = -BERGMAN_GLUCAGON_DECAY * s.Y + glucagon_rate;
+}
+
+/******************************************************
+ *   one iteration, fixed step RK4                    *
+ ******************************************************/
+bool BergmanBody::changeBloodSugarLevel(float strength, bool increasing, bool use_insulin_constant, bool use_glucagon_constant) {
+
+    // Body changes the BSL by the factor strength per iteration,
+    // the same relative rate per minute
+    double disturbance = log(strength) / BERGMAN_ITERATION_MINUTES;
+    if (increasing == false) {
+        disturbance = -disturbance;
+    }
+    // a used unit is infused evenly over the iteration, so the amount does not depend on the step
+    double insulin_rate = use_insulin_constant ? BERGMAN_INSULIN_PER_UNIT / BERGMAN_ITERATION_MINUTES : 0;
+    double glucagon_rate = use_glucagon_constant ? 1.0 / BERGMAN_ITERATION_MINUTES : 0;
+
+    // equal steps that fit the iteration exactly
+    int steps = (int)ceil(BERGMAN_ITERATION_MINUTES / StepMinutes - 1e-9);
+    double h = BERGMAN_ITERATION_MINUTES / steps;
+
+    for (int step = 0; step < steps; step++) {
+        bergmanstate k1, k2, k3, k4, tmp;
+        derivatives(State, disturbance, insulin_rate, glucagon_rate, k1);
+        tmp.G = State.G + h / 2 * k1.G; tmp.X = State.X + h / 2 * k1.X;
+        tmp.I = State.I + h / 2 * k1.I; tmp.Y = State.Y + h / 2 * k1.Y;
+        derivatives(tmp, disturbance, insulin_rate, glucagon_rate, k2);
+        tmp.G = State.G + h / 2 * k2.G; tmp.X = State.X + h / 2 * k2.X;
+        tmp.I = State.I + h / 2 * k2.I; tmp.Y = State.Y + h / 2 * k2.Y;
+        derivatives(tmp, disturbance, insulin_rate, glucagon_rate, k3);
+        tmp.G = State.G + h * k3.G; tmp.X = State.X + h * k3.X;
+        tmp.I = State.I + h * k3.I; tmp.Y = State.Y + h * k3.Y;
+        derivatives(tmp, disturbance, insulin_rate, glucagon_rate, k4);
+
+        State.G += h / 6 * (k1.G + 2 * k2.G + 2 * k3.G + k4.G);
+        State.X += h / 6 * (k1.X + 2 * k2.X + 2 * k3.X + k4.X);
+        State.I += h / 6 * (k1.I + 2 * k2.I + 2 * k3.I + k4.I);
+        State.Y += h / 6 * (k1.Y + 2 * k2.Y + 2 * k3.Y + k4.Y);
+    }
+
+    if (State.G < 0) {
+        State.G = 0;
+    }
+
+    return true;
+}
+
+/******************************************************
+ *   many iterations, no kernels to pick here         *
+ ******************************************************/
+void BergmanBody::simulateSteps(long steps, float strength, bool increasing, int &insulin_units, int &glucagon_units, float *samples) {
+    for (long step = 0; step < steps; step++) {
+        simulateStep(strength, increasing, insulin_units, glucagon_units);
+        if (samples) {
+            samples[step] = getBloodSugarLevel();
+        }
+    }
+}
+
+/******************************************************
+ *      declaring getter and setter methods           *
+ ******************************************************/
+void BergmanBody::setBloodSugarLevel(float BSL) {
+    State.G = BSL;
+}
+
+float BergmanBody::getBloodSugarLevel() {
+    return (float)State.G;
+}
+
+void BergmanBody::setStepMinutes(double step_minutes) {
+    if (step_minutes <= 0 || step_minutes > BERGMAN_MAX_STEP_MINUTES) {
+        step_minutes = BERGMAN_STEP_MINUTES;
+    }
+    this->StepMinutes = step_minutes;
+}
+
+double BergmanBody::getStepMinutes() {
+    return this->StepMinutes;
+}
+
+/****************************************************************
+ *                      END BergmanBody                         *
+ ****************************************************************/
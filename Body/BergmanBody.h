@@ -0,0 +1,66 @@
+//
+//
+//  BergmanBody.h
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Body with continuous glucose/insulin/glucagon compartments (Bergman minimal model)
+//               integrated by a fixed step RK4 solver, one iteration still is 0.5 hours.
+//
+
+#ifndef bergmanBody_
+#define bergmanBody_
+
+#include "Body.h"
+
+#define BERGMAN_ITERATION_MINUTES   30.0        // one iteration of the simulation, like Body
+#define BERGMAN_STEP_MINUTES        1.0         // default RK4 step
+#define BERGMAN_MAX_STEP_MINUTES    15.0        // RK4 turns unstable near 2.8 / BERGMAN_N
+
+// minimal model parameters, time in minutes
+#define BERGMAN_P1                  0.0287      // glucose effectiveness [1/min]
+#define BERGMAN_P2                  0.0283      // remote insulin decay [1/min]
+#define BERGMAN_P3                  5.035e-5    // remote insulin gain [1/min^2 per uU/mL]
+#define BERGMAN_N                   0.0926      // plasma insulin clearance [1/min]
+#define BERGMAN_BASAL_INSULIN       10.0        // basal plasma insulin [uU/mL]
+#define BERGMAN_INSULIN_PER_UNIT    2.5         // plasma insulin of one pump unit [uU/mL]
+#define BERGMAN_GLUCAGON_DECAY      0.1         // glucagon clearance [1/min]
+#define BERGMAN_GLUCAGON_GAIN       0.5         // glucose release per glucagon [mg/dL/min]
+
+class BergmanBody : public Body {
+    public:
+
+    // natural (basal) BSL and the RK4 step in minutes, the step is shortened
+    // to fit the iteration a whole number of times
+    BergmanBody(float BSL, double step_minutes);
+    ~BergmanBody();
+
+    // integrates one iteration (30 min); the strength becomes a glucose appearance
+    // (increasing) or uptake (falling) rate of the same size as in Body, a used
+    // insulin/glucagon unit is infused over the iteration
+    virtual bool changeBloodSugarLevel(float strength, bool increasing, bool use_insulin_constant, bool use_glucagon_constant);
+    // step by step, every step integrates the model
+    virtual void simulateSteps(long steps, float strength, bool increasing, int &insulin_units, int &glucagon_units, float *samples);
+    virtual float getBloodSugarLevel();
+    virtual void setBloodSugarLevel(float);
+
+    virtual void setStepMinutes(double step_minutes);
+    virtual double getStepMinutes();
+
+    private:
+    // G: glucose [mg/dL], X: remote insulin [1/min], I: plasma insulin [uU/mL], Y: glucagon
+    struct bergmanstate {
+        double G, X, I, Y;
+    };
+
+    // derivatives for the given disturbance [1/min] and infusion rates [per min]
+    void derivatives(const bergmanstate &s, double disturbance, double insulin_rate,
+                     double glucagon_rate, bergmanstate &d);
+
+    bergmanstate State;
+    double BasalGlucose;
+    double StepMinutes;
+};
+#endif
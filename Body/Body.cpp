@@ -0,0 +1,156 @@
+//
+//
+//  Body.cpp
+//  Body
+//
+//  Created by Johannes Kinzig on 04.01.15.
+//  Copyright (c) 2015 Johannes Kinzig. All rights reserved.
+//                     Sven Sperner, sillyconn@gmail.com
+//                     - moved out of main.cpp, linked into the pump for in-process runs
+//                     - added simulateStep()
+//                     - replaced the branch chain by compile time specialized kernels
+//                     - added simulateSteps()
+//
+//  Description: Simulates a body suffering from diabetes and reacting to insulin and/or glucagon.
+//
+
+#include "Body.h"
+
+/****************************************************************
+ *                      Class: Body                             *
+ ****************************************************************/
+
+// constructor
+Body::Body(float BSL, int in_constant, int gluc_constant){
+    BloodsugarLevel = BSL; // unit: mg/dL
+    insulin_constant = in_constant; // unit: mg/dL sinking per iteration => one iteration estimated as 0.5 hours
+    glucagon_constant = gluc_constant; // glucagon which influences the BSL per 0.5 hours
+    
+}
+
+// destructor
+Body::~Body(){
+    
+}
+
+/******************************************************
+ *   defined 3 levels for increasing/decreasing:      *
+ *      Level 1: calm   --> 1.03                      *
+ *      Level 2: middle --> 1.06                      *
+ *      Level 3: fast   --> 1.09                      *
+ ******************************************************/
+
+// the kernels by [increasing][use_insulin_constant][use_glucagon_constant]
+static const BodyKernel Kernels[2][2][2] = {
+    { { bodyKernel<false, false, false>, bodyKernel<false, false, true> },
+      { bodyKernel<false, true, false>,  bodyKernel<false, true, true> } },
+    { { bodyKernel<true, false, false>,  bodyKernel<true, false, true> },
+      { bodyKernel<true, true, false>,   bodyKernel<true, true, true> } }
+};
+
+bool Body::changeBloodSugarLevel(float strength, bool increasing, bool use_insulin_constant, bool use_glucagon_constant) {
+    
+    this->BloodsugarLevel = Kernels[increasing][use_insulin_constant][use_glucagon_constant](
+        this->BloodsugarLevel, strength, this->insulin_constant, this->glucagon_constant);
+    
+    return true;
+    
+}
+
+/******************************************************
+ *   one simulation step (~0.5 h) with pending units  *
+ ******************************************************/
+void Body::simulateStep(float strength, bool increasing, int &insulin_units, int &glucagon_units) {
+
+    // generate BSL graph by reacting or not reacting to insulin
+    if (insulin_units > 0 && glucagon_units == 0) {
+        changeBloodSugarLevel(strength, increasing, true, false);
+        insulin_units--;
+    }
+
+    else if (insulin_units == 0 && glucagon_units == 0) {
+        changeBloodSugarLevel(strength, increasing, false, false);
+    }
+
+    // generate BSL graph by reacting or not reacting to glucagon
+    else if (glucagon_units > 0 && insulin_units == 0) {
+        changeBloodSugarLevel(strength, increasing, false, true);
+        glucagon_units--;
+    }
+}
+
+/******************************************************
+ *   many simulation steps, split into phases with    *
+ *   the same kernel: pending insulin, pending        *
+ *   glucagon, none pending or both (no change)       *
+ ******************************************************/
+void Body::simulateSteps(long steps, float strength, bool increasing, int &insulin_units, int &glucagon_units, float *samples) {
+    if (increasing) {
+        runSteps<true>(steps, strength, insulin_units, glucagon_units, samples);
+    }
+    else {
+        runSteps<false>(steps, strength, insulin_units, glucagon_units, samples);
+    }
+}
+
+template <bool increasing>
+void Body::runSteps(long steps, float strength, int &insulin_units, int &glucagon_units, float *samples) {
+    float level = this->BloodsugarLevel;
+    long done = 0;
+
+    while (done < steps) {
+        long phase = steps - done;
+        float *phase_samples = samples ? samples + done : NULL;
+
+        if (insulin_units > 0 && glucagon_units == 0) {
+            phase = phase < insulin_units ? phase : insulin_units;
+            level = runKernel<increasing, true, false>(level, phase, strength, phase_samples);
+            insulin_units -= phase;
+        }
+        else if (glucagon_units > 0 && insulin_units == 0) {
+            phase = phase < glucagon_units ? phase : glucagon_units;
+            level = runKernel<increasing, false, true>(level, phase, strength, phase_samples);
+            glucagon_units -= phase;
+        }
+        else if (insulin_units == 0 && glucagon_units == 0) {
+            level = runKernel<increasing, false, false>(level, phase, strength, phase_samples);
+        }
+        else {
+            // both pending (or negative): simulateStep() leaves everything as it is
+            level = runKernel<increasing, true, true>(level, phase, strength, phase_samples);
+        }
+        done += phase;
+    }
+
+    this->BloodsugarLevel = level;
+}
+
+template <bool increasing, bool use_insulin_constant, bool use_glucagon_constant>
+float Body::runKernel(float level, long steps, float strength, float *samples) {
+    float insulin = this->insulin_constant;
+    float glucagon = this->glucagon_constant;
+
+    for (long step = 0; step < steps; step++) {
+        level = bodyKernel<increasing, use_insulin_constant, use_glucagon_constant>(level, strength, insulin, glucagon);
+        if (samples) {
+            samples[step] = level;
+        }
+    }
+    return level;
+}
+
+/******************************************************
+ *      declaring getter and setter methods           *
+ *      for private var BloodsugarLevel               *
+ ******************************************************/
+void Body::setBloodSugarLevel(float BSL) {
+    this->BloodsugarLevel = BSL;
+}
+
+float Body::getBloodSugarLevel() {
+    return this->BloodsugarLevel;
+}
+
+/****************************************************************
+ *                          END Body                            *
+ ****************************************************************/
@@ -15,20 +15,61 @@
 #include <vector>
 #include <string>
 
+// one update of the BSL, specialized at compile time for the direction and the used
+// constants; insulin & glucagon together leave the BSL unchanged
+template <bool increasing, bool use_insulin_constant, bool use_glucagon_constant>
+inline float bodyKernel(float BSL, float strength, float insulin_constant, float glucagon_constant) {
+    float level = increasing ? BSL * strength : BSL / strength;
+    if (use_insulin_constant) {
+        level = level - insulin_constant;
+    }
+    if (use_glucagon_constant) {
+        level = level + glucagon_constant;
+    }
+    return level;
+}
+
+template <>
+inline float bodyKernel<false, true, true>(float BSL, float, float, float) {
+    return BSL;
+}
+
+template <>
+inline float bodyKernel<true, true, true>(float BSL, float, float, float) {
+    return BSL;
+}
+
+typedef float (*BodyKernel)(float BSL, float strength, float insulin_constant, float glucagon_constant);
+
 class Body {
     public:
     
     Body(float BSL, int insulin_constant, int gluc_constant);
-    ~Body();
+    virtual ~Body();
     
     // changes the blood sugar level;
     // increasing: if True: rising; if False: falling
     // strength: the factor the BSL is rising or falling
     virtual bool changeBloodSugarLevel(float strength, bool increasing, bool use_insulin_constant, bool use_glucagon_constant);
+
+    // one simulation step: uses up one of the pending insulin or glucagon units
+    // (none if both are pending) and changes the BSL accordingly
+    virtual void simulateStep(float strength, bool increasing, int &insulin_units, int &glucagon_units);
+
+    // many simulation steps, the same as calling simulateStep() that often; the
+    // kernels are picked once per phase of pending units and run inlined
+    // samples: receives the BSL after every step, may be NULL
+    virtual void simulateSteps(long steps, float strength, bool increasing, int &insulin_units, int &glucagon_units, float *samples);
     virtual float getBloodSugarLevel();
     virtual void setBloodSugarLevel(float);
     
     private:
+    template <bool increasing>
+    void runSteps(long steps, float strength, int &insulin_units, int &glucagon_units, float *samples);
+
+    template <bool increasing, bool use_insulin_constant, bool use_glucagon_constant>
+    float runKernel(float level, long steps, float strength, float *samples);
+
     float BloodsugarLevel;
     int insulin_constant;
     int glucagon_constant;
@@ -4,14 +4,34 @@ CONFIG -= app_bundle
 CONFIG -= qt
 CONFIG += c++11
 
-LIBS += -pthread
+LIBS += -pthread -lrt
 
-SOURCES += main.cpp
+INCLUDEPATH += ..
+
+SOURCES += main.cpp \
+    BergmanBody.cpp \
+    Body.cpp \
+    BodyBenchmark.cpp \
+    BodyPopulation.cpp \
+    BodyThreadController.cpp \
+    SampleLog.cpp \
+    ScenarioScript.cpp \
+    ../SharedMemoryRing.cpp \
+    ../UnixSocketChannel.cpp \
+    ../WireProtocol.cpp
 
 include(deployment.pri)
 qtcAddDeployment()
 
 HEADERS += \
+    BergmanBody.h \
     Body.h \
-    BodyThreadController.h
+    BodyBenchmark.h \
+    BodyPopulation.h \
+    BodyThreadController.h \
+    SampleLog.h \
+    ScenarioScript.h \
+    ../SharedMemoryRing.h \
+    ../UnixSocketChannel.h \
+    ../WireProtocol.h
 
@@ -0,0 +1,160 @@
+//
+//
+//  BodyBenchmark.cpp
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Headless benchmarks of the body models, cost & accuracy of the bergman model
+//               per RK4 step size and per step cost of the update kernels.
+//
+
+#include "BodyBenchmark.h"
+#include "BergmanBody.h"
+#include "Body.h"
+#include <iostream>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+
+#define STEP_HOURS      (BERGMAN_ITERATION_MINUTES / 60) // simulated time of one body iteration
+
+using namespace std;
+
+
+/******************************************************
+ *                Step-Size-Benchmark                 *
+ ******************************************************/
+bool Step_Size_Benchmark(long steps, float factor, bool rising) {
+    const double step_sizes[] = { 1.0 / 16, 0.25, 1.0, 2.0, 5.0, 10.0, 15.0 };
+    const int count = sizeof(step_sizes) / sizeof(step_sizes[0]);
+    double reference = 0;
+
+    cout << "Bergman model, " << steps * STEP_HOURS << " simulated hours\n"
+         << "step [min]   us per sim. hour   final BSL   deviation\n";
+
+    for (int i = 0; i < count; i++) {
+        BergmanBody model(110.00, step_sizes[i]);
+        // some insulin and glucagon units so all compartments are used
+        int insulin_units = 0, glucagon_units = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (long step = 0; step < steps; step++) {
+            if (step % 16 == 0) {
+                insulin_units = 3;
+            }
+            else if (step % 16 == 8) {
+                glucagon_units = 2;
+            }
+            model.simulateStep(factor, rising, insulin_units, glucagon_units);
+        }
+        double wall_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+        if (i == 0) {
+            reference = model.getBloodSugarLevel();
+        }
+        printf("%10.4f   %16.3f   %9.3f   %9.5f\n", step_sizes[i],
+               wall_us / (steps * STEP_HOURS), model.getBloodSugarLevel(),
+               fabs(model.getBloodSugarLevel() - reference));
+    }
+
+    return true;
+}
+/******************************************************
+ *              END Step-Size-Benchmark               *
+ ******************************************************/
+
+
+/******************************************************
+ *                  Kernel-Benchmark                  *
+ ******************************************************/
+// The update rule as it was before the kernels, only kept as reference; out of
+// line like the old virtual member, the compiler would fold the flags otherwise
+__attribute__((noinline)) static bool Branch_Chain(float &BSL, float strength, bool increasing, bool use_insulin_constant,
+                         bool use_glucagon_constant, int insulin_constant, int glucagon_constant) {
+    if (increasing == false && use_insulin_constant == false && use_glucagon_constant == false) {
+        BSL = BSL / strength;
+    }
+    else if (increasing == false && use_insulin_constant == false && use_glucagon_constant == true) {
+        BSL = BSL / strength;
+        BSL = BSL + glucagon_constant;
+    }
+    else if (increasing == false && use_insulin_constant == true && use_glucagon_constant == false) {
+        BSL = BSL / strength;
+        BSL = BSL - insulin_constant;
+    }
+    else if (increasing == true && use_insulin_constant == false && use_glucagon_constant == false) {
+        BSL = BSL * strength;
+    }
+    else if (increasing == true && use_insulin_constant == false && use_glucagon_constant == true) {
+        BSL = BSL * strength;
+        BSL = BSL + glucagon_constant;
+    }
+    else if (increasing == true && use_insulin_constant == true && use_glucagon_constant == false) {
+        BSL = BSL * strength;
+        BSL = BSL - insulin_constant;
+    }
+    return true;
+}
+
+// Every KERNEL_BLOCK steps some insulin or glucagon units are given
+bool Kernel_Benchmark(long steps, float factor, bool rising) {
+    long blocks = (steps + KERNEL_BLOCK - 1) / KERNEL_BLOCK;
+    float chain_bsl = 110.00;
+    Body stepped(110.00, 5, 5), batched(110.00, 5, 5);
+    int insulin_units = 0, glucagon_units = 0;
+    double ns[3];
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (long block = 0; block < blocks; block++) {
+        insulin_units = (block % 2 == 0) ? 3 : 0;
+        glucagon_units = (block % 2 == 1) ? 2 : 0;
+        for (int step = 0; step < KERNEL_BLOCK; step++) {
+            if (insulin_units > 0 && glucagon_units == 0) {
+                Branch_Chain(chain_bsl, factor, rising, true, false, 5, 5);
+                insulin_units--;
+            }
+            else if (insulin_units == 0 && glucagon_units == 0) {
+                Branch_Chain(chain_bsl, factor, rising, false, false, 5, 5);
+            }
+            else if (glucagon_units > 0 && insulin_units == 0) {
+                Branch_Chain(chain_bsl, factor, rising, false, true, 5, 5);
+                glucagon_units--;
+            }
+        }
+    }
+    ns[0] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (long block = 0; block < blocks; block++) {
+        insulin_units = (block % 2 == 0) ? 3 : 0;
+        glucagon_units = (block % 2 == 1) ? 2 : 0;
+        for (int step = 0; step < KERNEL_BLOCK; step++) {
+            stepped.simulateStep(factor, rising, insulin_units, glucagon_units);
+        }
+    }
+    ns[1] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (long block = 0; block < blocks; block++) {
+        insulin_units = (block % 2 == 0) ? 3 : 0;
+        glucagon_units = (block % 2 == 1) ? 2 : 0;
+        batched.simulateSteps(KERNEL_BLOCK, factor, rising, insulin_units, glucagon_units, NULL);
+    }
+    ns[2] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+    long total = blocks * KERNEL_BLOCK;
+    bool match = chain_bsl == stepped.getBloodSugarLevel() && chain_bsl == batched.getBloodSugarLevel();
+    cout << "Kernel benchmark: " << total << " steps\n"
+         << "  branch chain:    " << ns[0] / total << " ns/step\n"
+         << "  simulateStep():  " << ns[1] / total << " ns/step\n"
+         << "  simulateSteps(): " << ns[2] / total << " ns/step\n"
+         << "Final BSL " << batched.getBloodSugarLevel()
+         << (match ? ", all paths match" : ", paths do NOT match") << endl;
+
+    return match;
+}
+/******************************************************
+ *                END Kernel-Benchmark                *
+ ******************************************************/
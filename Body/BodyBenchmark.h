@@ -0,0 +1,28 @@
+//
+//
+//  BodyBenchmark.h
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Headless benchmarks of the body models, cost & accuracy of the bergman model
+//               per RK4 step size and per step cost of the update kernels.
+//
+
+#ifndef bodyBenchmark_
+#define bodyBenchmark_
+
+#define KERNEL_BLOCK    48  // kernel benchmark: steps between two injections (one day)
+
+// Runs the bergman model with the given scenario and a range of RK4 step
+// sizes, reports the cost per simulated hour and the deviation of the final
+// BSL from the finest step
+bool Step_Size_Benchmark(long steps, float factor, bool rising);
+
+// Per step cost of the old branch chain, of simulateStep() (kernel picked per
+// step, virtual) and of simulateSteps() (kernels picked per phase, inlined),
+// returns false if their final BSL differ
+bool Kernel_Benchmark(long steps, float factor, bool rising);
+
+#endif
@@ -0,0 +1,227 @@
+//
+//
+//  BodyPopulation.cpp
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Simulates a whole cohort of bodies at once, stored as structure of arrays
+//               and advanced with a branchless (SSE2/AVX2) kernel.
+//
+
+#include "BodyPopulation.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POPULATION_X86
+#endif
+
+/****************************************************************
+ *                  Class: BodyPopulation                       *
+ ****************************************************************/
+
+// constructor
+BodyPopulation::BodyPopulation(int size, float BSL, int insulin_constant, int gluc_constant) :
+    Size(size),
+    BloodsugarLevel(size, BSL),
+    Strength(size, 1.00),
+    Increasing(size, 0),
+    InsulinUnits(size, 0),
+    GlucagonUnits(size, 0),
+    InsulinConstant(size, insulin_constant),
+    GlucagonConstant(size, gluc_constant) {
+
+#ifdef POPULATION_X86
+    UseAVX2 = __builtin_cpu_supports("avx2");
+#else
+    UseAVX2 = false;
+#endif
+}
+
+// destructor
+BodyPopulation::~BodyPopulation(){
+
+}
+
+/******************************************************
+ *          setting up the single bodies              *
+ ******************************************************/
+void BodyPopulation::setBody(int index, float BSL, float strength, bool increasing) {
+    BloodsugarLevel[index] = BSL;
+    Strength[index] = strength;
+    Increasing[index] = increasing ? 1 : 0;
+}
+
+void BodyPopulation::setUnits(int index, int insulin_units, int glucagon_units) {
+    InsulinUnits[index] = insulin_units;
+    GlucagonUnits[index] = glucagon_units;
+}
+
+/******************************************************
+ *   one simulation step (~0.5 h) for all bodies      *
+ ******************************************************/
+void BodyPopulation::simulateStep() {
+    int done = 0;
+
+#ifdef POPULATION_X86
+    if (UseAVX2) {
+        done = simulateAVX2(Size);
+    }
+    else {
+        done = simulateSSE2(Size);
+    }
+#endif
+
+    simulateScalar(done, Size);
+}
+
+void BodyPopulation::simulate(long steps) {
+    for (long step = 0; step < steps; step++) {
+        simulateStep();
+    }
+}
+
+/******************************************************
+ *   the kernel, the same cases as Body::simulateStep *
+ *      only insulin  --> factor, minus constant      *
+ *      nothing       --> factor                      *
+ *      only glucagon --> factor, plus constant       *
+ *      anything else --> unchanged                   *
+ ******************************************************/
+void BodyPopulation::simulateScalar(int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        int insulin = InsulinUnits[i];
+        int glucagon = GlucagonUnits[i];
+        bool use_insulin = insulin > 0 && glucagon == 0;
+        bool use_glucagon = glucagon > 0 && insulin == 0;
+
+        if (!use_insulin && !use_glucagon && !(insulin == 0 && glucagon == 0)) {
+            continue;
+        }
+
+        float level = Increasing[i] ? BloodsugarLevel[i] * Strength[i]
+                                    : BloodsugarLevel[i] / Strength[i];
+        if (use_insulin) {
+            level = level - InsulinConstant[i];
+            InsulinUnits[i]--;
+        }
+        if (use_glucagon) {
+            level = level + GlucagonConstant[i];
+            GlucagonUnits[i]--;
+        }
+        BloodsugarLevel[i] = level;
+    }
+}
+
+#ifdef POPULATION_X86
+
+// 4 bodies per iteration, plain SSE2 has no blend: select with and/andnot/or
+int BodyPopulation::simulateSSE2(int end) {
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+
+    for (; i + 4 <= end; i += 4) {
+        __m128i insulin = _mm_loadu_si128((const __m128i*)&InsulinUnits[i]);
+        __m128i glucagon = _mm_loadu_si128((const __m128i*)&GlucagonUnits[i]);
+        __m128i no_insulin = _mm_cmpeq_epi32(insulin, zero);
+        __m128i no_glucagon = _mm_cmpeq_epi32(glucagon, zero);
+        __m128i use_insulin = _mm_and_si128(_mm_cmpgt_epi32(insulin, zero), no_glucagon);
+        __m128i use_glucagon = _mm_and_si128(_mm_cmpgt_epi32(glucagon, zero), no_insulin);
+        __m128i active = _mm_or_si128(_mm_or_si128(use_insulin, use_glucagon),
+                                      _mm_and_si128(no_insulin, no_glucagon));
+        __m128i rising = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&Increasing[i]), zero);
+
+        __m128 level = _mm_loadu_ps(&BloodsugarLevel[i]);
+        __m128 strength = _mm_loadu_ps(&Strength[i]);
+        __m128 up = _mm_mul_ps(level, strength);
+        __m128 down = _mm_div_ps(level, strength);
+        __m128 rising_ps = _mm_castsi128_ps(rising);
+        __m128 next = _mm_or_ps(_mm_and_ps(rising_ps, up), _mm_andnot_ps(rising_ps, down));
+
+        next = _mm_sub_ps(next, _mm_and_ps(_mm_castsi128_ps(use_insulin), _mm_loadu_ps(&InsulinConstant[i])));
+        next = _mm_add_ps(next, _mm_and_ps(_mm_castsi128_ps(use_glucagon), _mm_loadu_ps(&GlucagonConstant[i])));
+
+        __m128 active_ps = _mm_castsi128_ps(active);
+        level = _mm_or_ps(_mm_and_ps(active_ps, next), _mm_andnot_ps(active_ps, level));
+        _mm_storeu_ps(&BloodsugarLevel[i], level);
+
+        // the masks are -1 where a unit was used up
+        _mm_storeu_si128((__m128i*)&InsulinUnits[i], _mm_add_epi32(insulin, use_insulin));
+        _mm_storeu_si128((__m128i*)&GlucagonUnits[i], _mm_add_epi32(glucagon, use_glucagon));
+    }
+
+    return i;
+}
+
+// 8 bodies per iteration, only called when the CPU has AVX2
+__attribute__((target("avx2")))
+int BodyPopulation::simulateAVX2(int end) {
+    const __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256i insulin = _mm256_loadu_si256((const __m256i*)&InsulinUnits[i]);
+        __m256i glucagon = _mm256_loadu_si256((const __m256i*)&GlucagonUnits[i]);
+        __m256i no_insulin = _mm256_cmpeq_epi32(insulin, zero);
+        __m256i no_glucagon = _mm256_cmpeq_epi32(glucagon, zero);
+        __m256i use_insulin = _mm256_and_si256(_mm256_cmpgt_epi32(insulin, zero), no_glucagon);
+        __m256i use_glucagon = _mm256_and_si256(_mm256_cmpgt_epi32(glucagon, zero), no_insulin);
+        __m256i active = _mm256_or_si256(_mm256_or_si256(use_insulin, use_glucagon),
+                                         _mm256_and_si256(no_insulin, no_glucagon));
+        __m256i rising = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i*)&Increasing[i]), zero);
+
+        __m256 level = _mm256_loadu_ps(&BloodsugarLevel[i]);
+        __m256 strength = _mm256_loadu_ps(&Strength[i]);
+        __m256 next = _mm256_blendv_ps(_mm256_div_ps(level, strength),
+                                       _mm256_mul_ps(level, strength),
+                                       _mm256_castsi256_ps(rising));
+
+        next = _mm256_sub_ps(next, _mm256_and_ps(_mm256_castsi256_ps(use_insulin), _mm256_loadu_ps(&InsulinConstant[i])));
+        next = _mm256_add_ps(next, _mm256_and_ps(_mm256_castsi256_ps(use_glucagon), _mm256_loadu_ps(&GlucagonConstant[i])));
+
+        level = _mm256_blendv_ps(level, next, _mm256_castsi256_ps(active));
+        _mm256_storeu_ps(&BloodsugarLevel[i], level);
+
+        // the masks are -1 where a unit was used up
+        _mm256_storeu_si256((__m256i*)&InsulinUnits[i], _mm256_add_epi32(insulin, use_insulin));
+        _mm256_storeu_si256((__m256i*)&GlucagonUnits[i], _mm256_add_epi32(glucagon, use_glucagon));
+    }
+
+    return i;
+}
+
+#else
+
+int BodyPopulation::simulateSSE2(int end) {
+    return 0;
+}
+
+int BodyPopulation::simulateAVX2(int end) {
+    return 0;
+}
+
+#endif
+
+/******************************************************
+ *      declaring getter methods                      *
+ ******************************************************/
+int BodyPopulation::getSize() {
+    return this->Size;
+}
+
+float BodyPopulation::getBloodSugarLevel(int index) {
+    return this->BloodsugarLevel[index];
+}
+
+int BodyPopulation::getInsulinUnits(int index) {
+    return this->InsulinUnits[index];
+}
+
+int BodyPopulation::getGlucagonUnits(int index) {
+    return this->GlucagonUnits[index];
+}
+
+/****************************************************************
+ *                      END BodyPopulation                      *
+ ****************************************************************/
@@ -0,0 +1,59 @@
+//
+//
+//  BodyPopulation.h
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Simulates a whole cohort of bodies at once, stored as structure of arrays
+//               and advanced with a branchless (SSE2/AVX2) kernel.
+//
+
+#ifndef bodyPopulation_
+#define bodyPopulation_
+
+#include <vector>
+#include <stdint.h>
+
+class BodyPopulation {
+    public:
+
+    // all bodies start alike: natural BSL, insulin constant, glucagon constant,
+    // body factor 1.00 and falling, no pending units
+    BodyPopulation(int size, float BSL, int insulin_constant, int gluc_constant);
+    ~BodyPopulation();
+
+    // changes one body, like Body::setBloodSugarLevel() and the thread controller setters
+    virtual void setBody(int index, float BSL, float strength, bool increasing);
+    virtual void setUnits(int index, int insulin_units, int glucagon_units);
+
+    // one simulation step for every body, each the same as Body::simulateStep()
+    virtual void simulateStep();
+    virtual void simulate(long steps);
+
+    virtual int getSize();
+    virtual float getBloodSugarLevel(int index);
+    virtual int getInsulinUnits(int index);
+    virtual int getGlucagonUnits(int index);
+
+    private:
+    // advances the bodies [begin, end) without SIMD, also handles the tail
+    void simulateScalar(int begin, int end);
+    // advance as many bodies as fit the vector width, return the first one not done
+    int simulateSSE2(int end);
+    int simulateAVX2(int end);
+
+    int Size;
+    bool UseAVX2;
+
+    // one entry per body
+    std::vector<float>   BloodsugarLevel;
+    std::vector<float>   Strength;
+    std::vector<int32_t> Increasing;        // 1: rising, 0: falling
+    std::vector<int32_t> InsulinUnits;
+    std::vector<int32_t> GlucagonUnits;
+    std::vector<float>   InsulinConstant;
+    std::vector<float>   GlucagonConstant;
+};
+#endif
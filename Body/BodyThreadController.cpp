@@ -0,0 +1,161 @@
+//
+//
+//  BodyThreadController.cpp
+//  Body
+//
+//  Created by Johannes Kinzig on 09.01.15.
+//  Copyright (c) 2015 Johannes Kinzig. All rights reserved.
+//                     Sven Sperner, sillyconn@gmail.com
+//                     - moved out of main.cpp
+//                     - lock free command queue & seqlock state snapshot
+//
+//  Description: Simulates a body suffering from diabetes and reacting to insulin and/or glucagon.
+//
+
+#include "BodyThreadController.h"
+#include <thread>
+
+/*****************************************************************
+ *                   Class: ThreadController                     *
+ *****************************************************************/
+// constructor, destructor
+BodyThreadController::BodyThreadController() :
+    ThreadBodyFactor(1.00),
+    ThreadRising(false),
+    ThreadInsulinUnits(0),
+    ThreadGlucagonUnits(0),
+    ThreadEndThread(false),
+    CommandHead(0),
+    CommandTail(0),
+    StateSequence(0),
+    StateBloodsugarLevel(0),
+    StateBodyFactor(1.00),
+    StateRising(false),
+    StateInsulinUnits(0),
+    StateGlucagonUnits(0),
+    StateSteps(0) {
+}
+BodyThreadController::~BodyThreadController() {
+
+}
+
+//ThreadBodyFactor -- tells the thread the body factor
+void BodyThreadController::setThreadBodyFactor(float factor){
+    pushCommand(BODY_COMMAND_FACTOR, factor);
+}
+float BodyThreadController::getThreadBodyFactor(void) {
+    return this->ThreadBodyFactor;
+}
+
+// ThreadRising -- tells the thread to rise or fall the BSL level
+void BodyThreadController::setThreadRising(bool value) {
+    pushCommand(BODY_COMMAND_RISING, value ? 1 : 0);
+}
+bool BodyThreadController::getThreadRising(void) {
+    return this->ThreadRising;
+}
+
+// ThreadGlucagonUnits -- tells the thread the amount of glucagon units to use
+void BodyThreadController::setThreadGlucagonUnits(int units) {
+    this->ThreadGlucagonUnits = units;
+}
+
+int BodyThreadController::getThreadGlucagonUnits() {
+    return this->ThreadGlucagonUnits;
+}
+
+void BodyThreadController::minusThreadGlucagonUnits(int value) {
+    this->ThreadGlucagonUnits = this->ThreadGlucagonUnits - value;
+}
+
+// ThreadInsulinUnits -- tells the thread the amount of inuslin units to use
+void BodyThreadController::setThreadInsulinUnits(int units) {
+    this->ThreadInsulinUnits = units;
+}
+
+int BodyThreadController::getThreadInsulinUnits() {
+    return this->ThreadInsulinUnits;
+}
+
+void BodyThreadController::minusThreadInsulinUnits(int value) {
+    this->ThreadInsulinUnits = this->ThreadInsulinUnits - value;
+}
+
+// ThreadEndThread -- tells the thread to terminate
+void BodyThreadController::setThreadEndThread(bool value) {
+    this->ThreadEndThread.store(value, std::memory_order_release);
+}
+
+bool BodyThreadController::getThreadEndThread() {
+    return this->ThreadEndThread.load(std::memory_order_acquire);
+}
+
+/******************************************************
+ *   command queue, control --> simulation thread     *
+ ******************************************************/
+void BodyThreadController::pushCommand(int type, float value) {
+    uint32_t head = CommandHead.load(std::memory_order_relaxed);
+
+    // full: the simulation thread is behind, commands are rare so just wait
+    while (head - CommandTail.load(std::memory_order_acquire) == BODY_COMMAND_SLOTS) {
+        std::this_thread::yield();
+    }
+
+    Commands[head % BODY_COMMAND_SLOTS].type = type;
+    Commands[head % BODY_COMMAND_SLOTS].value = value;
+    CommandHead.store(head + 1, std::memory_order_release);
+}
+
+void BodyThreadController::applyCommands(void) {
+    uint32_t tail = CommandTail.load(std::memory_order_relaxed);
+    uint32_t head = CommandHead.load(std::memory_order_acquire);
+
+    for (; tail != head; tail++) {
+        const bodycommand &command = Commands[tail % BODY_COMMAND_SLOTS];
+        if (command.type == BODY_COMMAND_FACTOR) {
+            this->ThreadBodyFactor = command.value;
+        }
+        else if (command.type == BODY_COMMAND_RISING) {
+            this->ThreadRising = command.value != 0;
+        }
+    }
+    CommandTail.store(tail, std::memory_order_release);
+}
+
+/******************************************************
+ *   state snapshot, simulation --> any thread        *
+ ******************************************************/
+void BodyThreadController::publishState(float bloodsugar_level, uint64_t steps) {
+    uint32_t sequence = StateSequence.load(std::memory_order_relaxed);
+
+    StateSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    StateBloodsugarLevel.store(bloodsugar_level, std::memory_order_relaxed);
+    StateBodyFactor.store(ThreadBodyFactor, std::memory_order_relaxed);
+    StateRising.store(ThreadRising, std::memory_order_relaxed);
+    StateInsulinUnits.store(ThreadInsulinUnits, std::memory_order_relaxed);
+    StateGlucagonUnits.store(ThreadGlucagonUnits, std::memory_order_relaxed);
+    StateSteps.store(steps, std::memory_order_relaxed);
+
+    StateSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void BodyThreadController::getThreadState(bodystate *state) {
+    uint32_t before, after;
+
+    do {
+        before = StateSequence.load(std::memory_order_acquire);
+        state->bloodsugar_level = StateBloodsugarLevel.load(std::memory_order_relaxed);
+        state->body_factor = StateBodyFactor.load(std::memory_order_relaxed);
+        state->rising = StateRising.load(std::memory_order_relaxed);
+        state->insulin_units = StateInsulinUnits.load(std::memory_order_relaxed);
+        state->glucagon_units = StateGlucagonUnits.load(std::memory_order_relaxed);
+        state->steps = StateSteps.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = StateSequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+}
+/****************************************************************
+ *                  END BodyThreadController                    *
+ ****************************************************************/
@@ -5,6 +5,8 @@
 //
 //  Created by Johannes Kinzig on 09.01.15.
 //  Copyright (c) 2015 Johannes Kinzig. All rights reserved.
+//                     Sven Sperner, sillyconn@gmail.com
+//                     - lock free command queue & seqlock state snapshot
 //
 //  Description: Simulates a body suffering from diabetes and reacting to insulin and/or glucagon.
 //
@@ -14,44 +16,102 @@
 
 #include <vector>
 #include <string>
+#include <atomic>
+#include <stdint.h>
 
-//class for communicating with the BSL-generating-Thread
+#define BODY_COMMAND_SLOTS  64  // commands the control thread may queue ahead
+
+#define BODY_COMMAND_FACTOR 1   // value: body factor
+#define BODY_COMMAND_RISING 2   // value: != 0 for rising
+
+// one scenario change from the control thread
+struct bodycommand {
+    int type;
+    float value;
+};
+
+// what the simulation thread published last
+struct bodystate {
+    float bloodsugar_level;
+    float body_factor;
+    bool rising;
+    int insulin_units;
+    int glucagon_units;
+    uint64_t steps;
+};
+
+// class for communicating with the BSL-generating-Thread
+//
+// The control thread only queues commands (body factor, rising) and sets the
+// end flag. The simulation thread owns all values: it applies the queued
+// commands at step boundaries and publishes a snapshot after every step.
+// Neither side takes a lock.
 class BodyThreadController {
 public:
     // constructor, destructor
     BodyThreadController();
     ~BodyThreadController();
-    
+
     // ThreadBodyFactor -- tells the thread the body factor
+    // set: queued for the simulation thread; get: simulation thread only
     virtual void setThreadBodyFactor(float factor);
     virtual float getThreadBodyFactor(void);
-    
+
     // ThreadRising -- tells the thread to rise or fall the BSL level
+    // set: queued for the simulation thread; get: simulation thread only
     virtual void setThreadRising(bool value);
     virtual bool getThreadRising(void);
-    
+
     // ThreadGlucagonUnits -- tells the thread the amount of fictive glucagon units to use
+    // simulation thread only
     virtual void setThreadGlucagonUnits(int units);
     virtual int getThreadGlucagonUnits(void);
     virtual void minusThreadGlucagonUnits(int);
-    
+
     // ThreadUseInsulinUnits -- tells the thread the amount of fictive inuslin units to use
+    // simulation thread only
     virtual void setThreadInsulinUnits(int units);
     virtual int getThreadInsulinUnits(void);
     virtual void minusThreadInsulinUnits(int); // subtracts the argument from ThreadInsulinUnits
-    
-    // ThreadEndThread -- tells the thread to terminate
+
+    // ThreadEndThread -- tells the thread to terminate, any thread
     virtual void setThreadEndThread(bool value);
     virtual bool getThreadEndThread(void);
-    
-    
+
+    // simulation thread: applies the queued commands, call at step boundaries
+    virtual void applyCommands(void);
+
+    // simulation thread: publishes the state after the given number of steps
+    virtual void publishState(float bloodsugar_level, uint64_t steps);
+
+    // any thread: the last published state
+    virtual void getThreadState(bodystate *state);
+
+
 private:
+    // owned by the simulation thread
     float   ThreadBodyFactor;
     bool    ThreadRising;
     int     ThreadInsulinUnits;
     int     ThreadGlucagonUnits;
-    bool    ThreadEndThread;
 
+    std::atomic<bool> ThreadEndThread;
+
+    // single producer / single consumer ring of commands
+    bodycommand Commands[BODY_COMMAND_SLOTS];
+    std::atomic<uint32_t> CommandHead;  // next slot to write, control thread
+    std::atomic<uint32_t> CommandTail;  // next slot to read, simulation thread
+
+    // seqlock: odd while the snapshot is written
+    std::atomic<uint32_t> StateSequence;
+    std::atomic<float>    StateBloodsugarLevel;
+    std::atomic<float>    StateBodyFactor;
+    std::atomic<bool>     StateRising;
+    std::atomic<int>      StateInsulinUnits;
+    std::atomic<int>      StateGlucagonUnits;
+    std::atomic<uint64_t> StateSteps;
+
+    void pushCommand(int type, float value);
 };
 
 #endif
@@ -0,0 +1,112 @@
+//
+//
+//  SampleLog.cpp
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Streams the BSL samples of the body into log.txt and a compact binary log,
+//               both files stay open and are written through large buffers.
+//
+
+#include "SampleLog.h"
+
+/****************************************************************
+ *                      Class: SampleLog                        *
+ ****************************************************************/
+
+// constructor
+SampleLog::SampleLog(const char *text_file, const char *binary_file) :
+    TextFile(NULL),
+    BinaryFile(NULL),
+    TextBuffer(SAMPLE_LOG_BUFFER),
+    SampleCount(0),
+    LastFlush(std::chrono::steady_clock::now()) {
+
+    Samples.reserve(SAMPLE_LOG_BUFFER / sizeof(float));
+
+    if (text_file) {
+        TextFile = fopen(text_file, "a");
+        if (TextFile) {
+            setvbuf(TextFile, &TextBuffer[0], _IOFBF, TextBuffer.size());
+        }
+    }
+
+    if (binary_file) {
+        BinaryFile = fopen(binary_file, "ab");
+        // a new file starts with the header
+        if (BinaryFile && ftell(BinaryFile) == 0) {
+            samplelogheader header = { SAMPLE_LOG_MAGIC, sizeof(float) };
+            fwrite(&header, sizeof(header), 1, BinaryFile);
+        }
+    }
+}
+
+// destructor
+SampleLog::~SampleLog(){
+    flush();
+    if (TextFile) {
+        fclose(TextFile);
+    }
+    if (BinaryFile) {
+        fclose(BinaryFile);
+    }
+}
+
+/******************************************************
+ *   appending samples, the files are only touched    *
+ *   when a buffer is full or on the periodic flush   *
+ ******************************************************/
+void SampleLog::write(float BSL) {
+
+    if (TextFile) {
+        // same format as ofstream << float
+        fprintf(TextFile, "%g\n", BSL);
+    }
+
+    if (BinaryFile) {
+        Samples.push_back(BSL);
+        if (Samples.size() == Samples.capacity()) {
+            flushBinary();
+        }
+    }
+
+    SampleCount++;
+    if (std::chrono::steady_clock::now() - LastFlush >= std::chrono::milliseconds(SAMPLE_LOG_FLUSH_MS)) {
+        flush();
+    }
+}
+
+void SampleLog::flush() {
+    flushBinary();
+    if (BinaryFile) {
+        fflush(BinaryFile);
+    }
+    if (TextFile) {
+        fflush(TextFile);
+    }
+    LastFlush = std::chrono::steady_clock::now();
+}
+
+void SampleLog::flushBinary() {
+    if (BinaryFile && !Samples.empty()) {
+        fwrite(&Samples[0], sizeof(float), Samples.size(), BinaryFile);
+    }
+    Samples.clear();
+}
+
+/******************************************************
+ *      declaring getter methods                      *
+ ******************************************************/
+bool SampleLog::isValid() {
+    return TextFile != NULL && BinaryFile != NULL;
+}
+
+uint64_t SampleLog::getSamples() {
+    return this->SampleCount;
+}
+
+/****************************************************************
+ *                        END SampleLog                         *
+ ****************************************************************/
@@ -0,0 +1,58 @@
+//
+//
+//  SampleLog.h
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Streams the BSL samples of the body into log.txt and a compact binary log,
+//               both files stay open and are written through large buffers.
+//
+
+#ifndef sampleLog_
+#define sampleLog_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+
+#define SAMPLE_LOG_TEXT     "log.txt"
+#define SAMPLE_LOG_BINARY   "log.bin"
+#define SAMPLE_LOG_BUFFER   (1 << 20)   // bytes buffered per file
+#define SAMPLE_LOG_FLUSH_MS 1000        // samples reach the files at least this often
+#define SAMPLE_LOG_MAGIC    0x314c5342  // "BSL1"
+
+// header of the binary log, followed by one float (mg/dL) per sample
+struct samplelogheader {
+    uint32_t magic;
+    uint32_t sample_size;
+};
+
+class SampleLog {
+    public:
+
+    // opens both files for appending, NULL skips a file
+    SampleLog(const char *text_file, const char *binary_file);
+    virtual ~SampleLog();
+
+    // appends one sample to both files
+    virtual void write(float BSL);
+    // hands everything buffered to the files
+    virtual void flush();
+
+    virtual bool isValid();
+    virtual uint64_t getSamples();
+
+    private:
+    void flushBinary();
+
+    FILE *TextFile;
+    FILE *BinaryFile;
+    std::vector<char> TextBuffer;
+    std::vector<float> Samples;         // binary samples not yet written
+    uint64_t SampleCount;
+    std::chrono::steady_clock::time_point LastFlush;
+};
+#endif
@@ -0,0 +1,227 @@
+//
+//
+//  ScenarioScript.cpp
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Timeline of body scenarios (meals, exercise, rest) read from a file,
+//               replaces the interactive menu for unattended runs.
+//
+
+#include "ScenarioScript.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// named events, index = menu option - 1
+static const struct {
+    const char *name;
+    float factor;
+    bool rising;
+} Options[SCENARIO_OPTIONS] = {
+    { "sweets", 1.04, true  },  // 1: Eating a lot of sweets (BSL rising fast)
+    { "snack",  1.02, true  },  // 2: Eating a snack (BSL rising moderate)
+    { "rest",   1.00, false },  // 3: Doing nothing (Constant BSL)
+    { "water",  1.01, false },  // 4: Drinking water (BSL falling slowly)
+    { "sports", 1.05, false },  // 5: Doing sports (BSL falling)
+};
+
+static bool earlier(const scenarioevent &a, const scenarioevent &b) {
+    return a.step < b.step;
+}
+
+/****************************************************************
+ *                   Class: ScenarioScript                      *
+ ****************************************************************/
+
+// constructor
+ScenarioScript::ScenarioScript(const char *file, double hours_per_step) :
+    Next(0),
+    Base(0),
+    Valid(false),
+    ErrorLine(0),
+    HoursPerStep(hours_per_step) {
+
+    std::ifstream in(file);
+    if (!in) {
+        return;
+    }
+
+    std::string line;
+    int number = 0;
+    while (std::getline(in, line)) {
+        number++;
+        scenarioevent event;
+        if (!parseLine(line.c_str(), &event)) {
+            ErrorLine = number;
+            return;
+        }
+        if (event.type != 0) {
+            Events.push_back(event);
+        }
+    }
+
+    // same time: the order of the file
+    std::stable_sort(Events.begin(), Events.end(), earlier);
+    Valid = true;
+}
+
+// destructor
+ScenarioScript::~ScenarioScript(){
+
+}
+
+/******************************************************
+ *   "t=<time>[h|m]: [name] [factor <f>] [rising]",   *
+ *   type 0 for empty & comment lines                 *
+ ******************************************************/
+bool ScenarioScript::parseLine(const char *line, scenarioevent *event) {
+    std::string text(line);
+    text = text.substr(0, text.find('#'));
+
+    event->type = 0;
+    event->factor = 1.00;
+    event->rising = false;
+
+    const char *p = text.c_str();
+    while (*p == ' ' || *p == '\t' || *p == '\r') {
+        p++;
+    }
+    if (*p == '\0') {
+        return true;
+    }
+    if (strncmp(p, "t=", 2) != 0) {
+        return false;
+    }
+
+    char *end;
+    double hours = strtod(p + 2, &end);
+    if (end == p + 2 || hours < 0) {
+        return false;
+    }
+    if (*end == 'm') {
+        hours /= 60;
+        end++;
+    }
+    else if (*end == 'h') {
+        end++;
+    }
+    if (*end != ':') {
+        return false;
+    }
+    event->step = (uint64_t)llround(hours / HoursPerStep);
+
+    // the rest are words, brackets and commas only separate them
+    std::string words(end + 1);
+    std::replace(words.begin(), words.end(), '(', ' ');
+    std::replace(words.begin(), words.end(), ')', ' ');
+    std::replace(words.begin(), words.end(), ',', ' ');
+
+    char *save;
+    for (char *word = strtok_r(&words[0], " \t\r", &save); word; word = strtok_r(NULL, " \t\r", &save)) {
+        int option = 0;
+        for (int i = 0; i < SCENARIO_OPTIONS; i++) {
+            if (strcmp(word, Options[i].name) == 0) {
+                option = i + 1;
+            }
+        }
+
+        if (option > 0 && event->type == 0) {
+            getOption(option, &event->factor, &event->rising);
+            event->type = SCENARIO_BODY;
+        }
+        else if (strcmp(word, "factor") == 0 && event->type != SCENARIO_REPEAT && event->type != SCENARIO_END) {
+            word = strtok_r(NULL, " \t\r", &save);
+            if (!word) {
+                return false;
+            }
+            event->factor = strtof(word, &end);
+            if (*end != '\0' || event->factor <= 0) {
+                return false;
+            }
+            event->type = SCENARIO_BODY;
+        }
+        else if (strcmp(word, "rising") == 0 && event->type == SCENARIO_BODY) {
+            event->rising = true;
+        }
+        else if (strcmp(word, "falling") == 0 && event->type == SCENARIO_BODY) {
+            event->rising = false;
+        }
+        else if (strcmp(word, "repeat") == 0 && event->type == 0) {
+            event->type = SCENARIO_REPEAT;
+        }
+        else if (strcmp(word, "end") == 0 && event->type == 0) {
+            event->type = SCENARIO_END;
+        }
+        else {
+            return false;
+        }
+    }
+
+    // an empty event or a repeat at 0 that would never let the time advance
+    if (event->type == 0 || (event->type == SCENARIO_REPEAT && event->step == 0)) {
+        return false;
+    }
+    return true;
+}
+
+/******************************************************
+ *   consuming the timeline, O(1) per step            *
+ ******************************************************/
+const scenarioevent *ScenarioScript::next(uint64_t step) {
+    while (Next < Events.size()) {
+        const scenarioevent &event = Events[Next];
+        if (Base + event.step > step) {
+            return NULL;
+        }
+        Next++;
+        if (event.type == SCENARIO_REPEAT) {
+            Base += event.step;
+            Next = 0;
+            continue;
+        }
+        return &event;
+    }
+    return NULL;
+}
+
+long ScenarioScript::stepsUntilNext(uint64_t step) {
+    if (Next >= Events.size()) {
+        return -1;
+    }
+    uint64_t due = Base + Events[Next].step;
+    return due > step ? (long)(due - step) : 0;
+}
+
+/******************************************************
+ *      declaring getter methods                      *
+ ******************************************************/
+bool ScenarioScript::isValid() {
+    return this->Valid;
+}
+
+int ScenarioScript::getErrorLine() {
+    return this->ErrorLine;
+}
+
+int ScenarioScript::getEvents() {
+    return (int)this->Events.size();
+}
+
+bool ScenarioScript::getOption(int option, float *factor, bool *rising) {
+    if (option < 1 || option > SCENARIO_OPTIONS) {
+        return false;
+    }
+    *factor = Options[option - 1].factor;
+    *rising = Options[option - 1].rising;
+    return true;
+}
+
+/****************************************************************
+ *                     END ScenarioScript                       *
+ ****************************************************************/
@@ -0,0 +1,77 @@
+//
+//
+//  ScenarioScript.h
+//  Body
+//
+//  Created by Sven Sperner on 17.10.26.
+//  Copyright (c) 2026 Sven Sperner. All rights reserved.
+//
+//  Description: Timeline of body scenarios (meals, exercise, rest) read from a file,
+//               replaces the interactive menu for unattended runs.
+//
+//  Format, one event per line, '#' starts a comment:
+//
+//      t=0h:   rest
+//      t=2h:   snack (factor 1.02, rising)
+//      t=5h:   sports
+//      t=90m:  factor 1.03 falling
+//      t=24h:  repeat                      <- starts the timeline over
+//      t=72h:  end                         <- ends the simulation
+//
+//  Named events: sweets, snack, rest, water, sports (menu options 1-5),
+//  factor and rising/falling override the named values.
+//
+
+#ifndef scenarioScript_
+#define scenarioScript_
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCENARIO_BODY       1   // new body factor & direction
+#define SCENARIO_REPEAT     2   // timeline starts over at this step
+#define SCENARIO_END        3   // simulation ends at this step
+
+#define SCENARIO_OPTIONS    5   // named events, same as the menu options 1-5
+
+// one event of the timeline, time in body iterations
+struct scenarioevent {
+    uint64_t step;
+    int type;
+    float factor;
+    bool rising;
+};
+
+class ScenarioScript {
+    public:
+
+    // parses the whole file, times are rounded to iterations of hours_per_step
+    ScenarioScript(const char *file, double hours_per_step);
+    virtual ~ScenarioScript();
+
+    // the next event that is due at the given step, NULL if none;
+    // call repeatedly until NULL, the steps must not go backwards
+    virtual const scenarioevent *next(uint64_t step);
+    // steps from the given one to the next event, -1 if there is none
+    virtual long stepsUntilNext(uint64_t step);
+
+    virtual bool isValid();
+    // line of the first parse error, 0 if there was none
+    virtual int getErrorLine();
+    virtual int getEvents();
+
+    // body factor & direction of a menu option 1-5, false for any other option
+    static bool getOption(int option, float *factor, bool *rising);
+
+    private:
+    bool parseLine(const char *line, scenarioevent *event);
+
+    std::vector<scenarioevent> Events;  // sorted by step
+    size_t Next;                        // next event to hand out
+    uint64_t Base;                      // step the timeline (re)started at
+    bool Valid;
+    int ErrorLine;
+    double HoursPerStep;
+};
+#endif
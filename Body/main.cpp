@@ -8,13 +8,36 @@
 //                     Sven Sperner, sillyconn@gmail.com
 //                     - added 'doing nothing' to control thread
 //                     - modified output of bsl thread with leading CR (\r)
+//                     - added shared memory ring transport (-t shm)
+//                     - added unix domain socket transport (-t socket)
+//                     - added transport round trip benchmark (-B cycles)
+//                     - replaced ascii pipe format with binary wire frames
+//                     - moved Body & BodyThreadController to their own files
+//                     - added headless accelerated time mode (-H hours -s scenario)
+//                     - added headless population mode (-H hours -P patients)
+//                     - buffered log.txt writer, binary samples in log.bin
+//                     - added Bergman minimal model body with RK4 solver (-m bergman -h minutes)
+//                     - headless mode runs the specialized kernels in chunks, kernel benchmark (-K)
+//                     - scenario changes through the lock free controller, applied between steps
+//                     - scripted scenario files instead of the menu (-f file)
+//                     - moved the body benchmarks to BodyBenchmark.cpp
 //
 //  Description: Simulates a body suffering from diabetes and reacting to insulin and/or glucagon.
 //
 
+#include "BergmanBody.h"
 #include "Body.h"
+#include "BodyBenchmark.h"
+#include "BodyPopulation.h"
 #include "BodyThreadController.h"
+#include "SampleLog.h"
+#include "ScenarioScript.h"
+#include "Config.h"
+#include "SharedMemoryRing.h"
+#include "UnixSocketChannel.h"
+#include "WireProtocol.h"
 #include <iostream>
+#include <math.h>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,185 +47,240 @@
 #include <unistd.h>
 #include <thread>
 #include <fstream>
+#include <string.h>
+#include <chrono>
 
 using namespace std;
 
 #define BUFLEN          100 //<--- sizeof(struct) inststead of hard coded value
 #define EXIT__FAILURE   -1
+#define SHM_POLL_USEC   100 // wait between polls of the injection ring
+#define SHM_SPIN_USEC   200 // polls without sleeping first, a round trip takes ~10 us
+#define HOURS_PER_STEP  0.5 // simulated time of one body iteration
+#define POPULATION_CHECK 64 // patients compared against single Body objects
+#define HEADLESS_CHUNK  4096 // headless steps per simulateSteps() call
 
-int     main                        (void);
+int     main                        (int argc, char *argv[]);
 int     BSL_Sim_thread              (void); // is working
 int     Sim_Controll_Thread         (void); // seems to be working --> testing needed
+int     Pump_Emu_thread             (int cycles); // transport benchmark only
+int     receive_injection_frame     (wireframe *buffer);
+bool    apply_scenario              (int option);
+bool    run_script                  (uint64_t steps);
+int     Population_Sim              (long steps, int patients);
 
-// generate chars for pipe buffers
-char symbols_insulin[3];
-char symbols_glucagon[3];
+// sequencing & checking of the frames to and from the pump
+WireProtocol wire(WIRE_SENSOR, WIRE_INJECTION);
 
-/*****************************************************************
- *                   Class: ThreadController                     *
- *****************************************************************/
-// constructor, destructor
-BodyThreadController::BodyThreadController() {
-}
-BodyThreadController::~BodyThreadController() {
-
-}
-
-//ThreadBodyFactor -- tells the thread the body factor
-void BodyThreadController::setThreadBodyFactor(float factor){
-    this->ThreadBodyFactor = factor;
-}
-float BodyThreadController::getThreadBodyFactor(void) {
-    return this->ThreadBodyFactor;
-}
-
-// ThreadRising -- tells the thread to rise or fall the BSL level
-void BodyThreadController::setThreadRising(bool value) {
-    this->ThreadRising = value;
-}
-bool BodyThreadController::getThreadRising(void) {
-    return this->ThreadRising;
-}
-
-// ThreadGlucagonUnits -- tells the thread the amount of glucagon units to use
-void BodyThreadController::setThreadGlucagonUnits(int units) {
-    this->ThreadGlucagonUnits = units;
-}
-
-int BodyThreadController::getThreadGlucagonUnits() {
-    return this->ThreadGlucagonUnits;
-}
-
-void BodyThreadController::minusThreadGlucagonUnits(int value) {
-    this->ThreadGlucagonUnits = this->ThreadGlucagonUnits - value;
-}
-
-// ThreadInsulinUnits -- tells the thread the amount of inuslin units to use
-void BodyThreadController::setThreadInsulinUnits(int units) {
-    this->ThreadInsulinUnits = units;
-}
+// selected transport, the pump must be configured with the same
+int transport_mode = TRANSPORT_FILE;
 
-int BodyThreadController::getThreadInsulinUnits() {
-    return this->ThreadInsulinUnits;
-}
+// shared memory rings, created by the body in TRANSPORT_SHM mode
+SharedMemoryRing *ring_to_pump = NULL;
+SharedMemoryRing *ring_to_body = NULL;
 
-void BodyThreadController::minusThreadInsulinUnits(int value) {
-    this->ThreadInsulinUnits = this->ThreadInsulinUnits - value;
-}
-
-// ThreadEndThread -- tells the thread to terminate
-void BodyThreadController::setThreadEndThread(bool value) {
-    this->ThreadEndThread = value;
-}
+// unix domain socket, the body listens in TRANSPORT_SOCKET mode
+UnixSocketChannel *socket_channel = NULL;
 
-bool BodyThreadController::getThreadEndThread() {
-    return this->ThreadEndThread;
-}
-/****************************************************************
- *                  END BodyThreadController                    *
- ****************************************************************/
+// no per cycle console output, set by the benchmark
+bool quiet = false;
 
+// BSL samples, log.txt & log.bin
+SampleLog *sample_log = NULL;
 
-/****************************************************************
- *                      Class: Body                             *
- ****************************************************************/
+// headless mode: iterations left to simulate without a pump, 0 if not headless
+long headless_steps = 0;
 
-// constructor
-Body::Body(float BSL, int in_constant, int gluc_constant){
-    BloodsugarLevel = BSL; // unit: mg/dL
-    insulin_constant = in_constant; // unit: mg/dL sinking per iteration => one iteration estimated as 0.5 hours
-    glucagon_constant = gluc_constant; // glucagon which influences the BSL per 0.5 hours
-    
-}
+// scenario file replacing the menu, NULL if interactive
+ScenarioScript *script = NULL;
 
-// destructor
-Body::~Body(){
-    
-}
 
 /******************************************************
- *   defined 3 levels for increasing/decreasing:      *
- *      Level 1: calm   --> 1.03                      *
- *      Level 2: middle --> 1.06                      *
- *      Level 3: fast   --> 1.09                      *
+ *                       Main                         *
  ******************************************************/
 
-bool Body::changeBloodSugarLevel(float strength, bool increasing, bool use_insulin_constant, bool use_glucagon_constant) {
-    
-    if (increasing == false && use_insulin_constant == false && use_glucagon_constant == false) {
-        // BSL falling with body factor
-        this->BloodsugarLevel = this->BloodsugarLevel / strength;
-    }
-    
-    else if (increasing == false && use_insulin_constant == false && use_glucagon_constant == true) {
-        //BSL falling with body factor + adding the glucagon constant
-        this->BloodsugarLevel = this->BloodsugarLevel / strength;
-        this->BloodsugarLevel = this->BloodsugarLevel + this->glucagon_constant;
-    }
-    
-    else if (increasing == false && use_insulin_constant == true && use_glucagon_constant == false) {
-        // BSL falling with body factor + falling with the additional insulin constant
-        this->BloodsugarLevel = this->BloodsugarLevel / strength;
-        this->BloodsugarLevel = this->BloodsugarLevel - this->insulin_constant;
-    }
-    
-    else if (increasing == false && use_insulin_constant == true && use_glucagon_constant == true) {
-        // injecting insulin and glucagon at the same time??? does this make sense???
-    }
-    
-    else if (increasing == true && use_insulin_constant == false && use_glucagon_constant == false) {
-        // rising gently
-        this->BloodsugarLevel = this->BloodsugarLevel * strength;
+Body *body = NULL; // generated in main, Body or BergmanBody
+BodyThreadController communication; // generate object for communication
+
+
+int main(int argc, char *argv[]) {
+
+    int opt;
+    int bench_cycles = 0;
+    double headless_hours = 0;
+    int scenario = 3;
+    int patients = 0;
+    bool bergman = false;
+    bool kernel_bench = false;
+    double step_minutes = BERGMAN_STEP_MINUTES;
+    const char *script_file = NULL;
+    while ((opt = getopt(argc, argv, "t:B:H:s:P:m:h:Kf:")) != -1) {
+        if (opt == 't' && strcmp(optarg, "file") == 0) {
+            transport_mode = TRANSPORT_FILE;
+        }
+        else if (opt == 't' && strcmp(optarg, "shm") == 0) {
+            transport_mode = TRANSPORT_SHM;
+        }
+        else if (opt == 't' && strcmp(optarg, "socket") == 0) {
+            transport_mode = TRANSPORT_SOCKET;
+        }
+        else if (opt == 'B' && atoi(optarg) > 0) {
+            bench_cycles = atoi(optarg);
+        }
+        else if (opt == 'H' && atof(optarg) > 0) {
+            headless_hours = atof(optarg);
+        }
+        else if (opt == 's' && atoi(optarg) >= 1 && atoi(optarg) <= 5) {
+            scenario = atoi(optarg);
+        }
+        else if (opt == 'P' && atoi(optarg) > 0) {
+            patients = atoi(optarg);
+        }
+        else if (opt == 'm' && strcmp(optarg, "bergman") == 0) {
+            bergman = true;
+        }
+        else if (opt == 'm' && strcmp(optarg, "factor") == 0) {
+            bergman = false;
+        }
+        else if (opt == 'h' && atof(optarg) >= 0) {
+            step_minutes = atof(optarg);
+        }
+        else if (opt == 'K') {
+            kernel_bench = true;
+        }
+        else if (opt == 'f') {
+            script_file = optarg;
+        }
+        else {
+            patients = -1;
+            break;
+        }
     }
-    
-    else if (increasing == true && use_insulin_constant == false && use_glucagon_constant == true) {
-        // rising with body factor + adding glucagon constant
-        this->BloodsugarLevel = this->BloodsugarLevel * strength;
-        this->BloodsugarLevel = this->BloodsugarLevel + this->glucagon_constant;
+    if (patients < 0 || (script_file && (bench_cycles > 0 || patients > 0 || kernel_bench || (bergman && step_minutes == 0)))) {
+        cerr << "Usage: " << argv[0] << " [-t file|shm|socket] [-m factor|bergman [-h minutes]] [-f scenariofile]\n"
+             << "            [-B cycles] [-H hours [-s 1-5] [-P patients | -K]]\n"
+             << "  -f: scenario timeline instead of the menu, not with -B, -P, -K or -h 0\n"
+             << "  -h 0 with -H: cost & accuracy of the bergman model per RK4 step size\n"
+             << "  -K with -H: per step cost of the body update kernels\n";
+        return EXIT__FAILURE;
     }
-    
-    else if (increasing == true && use_insulin_constant == true && use_glucagon_constant == false) {
-        // rising with body factor + subtracting the insulin constant
-        this->BloodsugarLevel = this->BloodsugarLevel * strength;
-        this->BloodsugarLevel = this->BloodsugarLevel - this->insulin_constant;
+
+    cout << "Start\n";
+
+    if (bergman) {
+        // natural BSL, RK4 step
+        body = new BergmanBody(110.00, step_minutes);
     }
-    
-    else if (increasing == true && use_insulin_constant == true && use_glucagon_constant == true) {
-        // rising + injecting insulin + injecting glucagon at the same time, does this make sense???
+    else {
+        // natural BSL, insulin constant, glucagon constant
+        body = new Body(110.00, 5, 5);
     }
-    
-    return true;
-    
-}
 
-/******************************************************
- *      declaring getter and setter methods           *
- *      for private var BloodsugarLevel               *
- ******************************************************/
-void Body::setBloodSugarLevel(float BSL) {
-    this->BloodsugarLevel = BSL;
-}
+    sample_log = new SampleLog(SAMPLE_LOG_TEXT, SAMPLE_LOG_BINARY);
+    if (!sample_log->isValid()) {
+        cout << "Could not open " << SAMPLE_LOG_TEXT << " or " << SAMPLE_LOG_BINARY << "!\n";
+        return EXIT__FAILURE;
+    }
 
-float Body::getBloodSugarLevel() {
-    return this->BloodsugarLevel;
-}
+    if (script_file) {
+        // parsed once, the simulation only walks the event array
+        script = new ScenarioScript(script_file, HOURS_PER_STEP);
+        if (!script->isValid()) {
+            cout << "Could not read " << script_file;
+            if (script->getErrorLine() > 0) {
+                cout << ", line " << script->getErrorLine();
+            }
+            cout << "!\n";
+            delete script;
+            delete sample_log;
+            delete body;
+            return EXIT__FAILURE;
+        }
+        cout << "Scenario file " << script_file << ": " << script->getEvents() << " events\n";
+    }
 
-/****************************************************************
- *                          END Body                            *
- ****************************************************************/
+    if (headless_hours > 0) {
+        // no pump, no prompt: the body runs open loop as fast as possible
+        quiet = true;
+        headless_steps = (long)ceil(headless_hours / HOURS_PER_STEP);
+        long steps = headless_steps;
+        communication.setThreadInsulinUnits(0);
+        communication.setThreadGlucagonUnits(0);
+        communication.setThreadEndThread(false);
+        apply_scenario(scenario);
+        // no simulation thread yet, main takes its part
+        communication.applyCommands();
+
+        if (bergman && step_minutes == 0) {
+            int result = Step_Size_Benchmark(steps, communication.getThreadBodyFactor(),
+                                             communication.getThreadRising()) ? 0 : EXIT__FAILURE;
+            delete sample_log;
+            delete body;
+            cout << "End\n";
+            return result;
+        }
 
+        if (kernel_bench) {
+            int result = Kernel_Benchmark(steps, communication.getThreadBodyFactor(),
+                                          communication.getThreadRising()) ? 0 : EXIT__FAILURE;
+            delete sample_log;
+            delete body;
+            cout << "End\n";
+            return result;
+        }
 
-/******************************************************
- *                       Main                         *
- ******************************************************/
+        if (patients > 0) {
+            int result = Population_Sim(steps, patients);
+            delete sample_log;
+            delete body;
+            cout << "End\n";
+            return result;
+        }
 
-Body body(110.00, 5, 5); // generate Body object - natural BSL, insulin constant, glucagon constant
-BodyThreadController communication; // generate object for communication
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        BSL_Sim_thread();
+        double wall_s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
+        // a scenario file may end the simulation early
+        bodystate state;
+        communication.getThreadState(&state);
+        steps = (long)state.steps;
 
-int main(void) {
+        double sim_hours = steps * HOURS_PER_STEP;
+        cout << "Headless simulation: ";
+        if (script) {
+            cout << "scenario file " << script_file;
+        }
+        else {
+            cout << "scenario " << scenario;
+        }
+        cout << ", " << sim_hours
+             << " simulated hours (" << steps << " steps) in " << wall_s << " s\n"
+             << "Throughput: " << (wall_s > 0 ? sim_hours / wall_s : 0)
+             << " simulated hours per wall second\n"
+             << "Final BSL: " << body->getBloodSugarLevel() << endl;
+        delete script;
+        delete sample_log;
+        delete body;
+        cout << "End\n";
+        return 0;
+    }
 
-    cout << "Start\n";
+    if (transport_mode == TRANSPORT_SHM) {
+        ring_to_pump = new SharedMemoryRing(SHM_RING_TO_PUMP, true);
+        ring_to_body = new SharedMemoryRing(SHM_RING_TO_BODY, true);
+        if (!ring_to_pump->isValid() || !ring_to_body->isValid()) {
+            cout << "Could not create shared memory rings!\n";
+            return EXIT__FAILURE;
+        }
+    }
+    else if (transport_mode == TRANSPORT_SOCKET) {
+        socket_channel = new UnixSocketChannel(SOCKET_PATH, true);
+        if (!socket_channel->isValid()) {
+            cout << "Could not listen on " << SOCKET_PATH << "!\n";
+            return EXIT__FAILURE;
+        }
+    }
     
     // Init values
     communication.setThreadBodyFactor(1.03);
@@ -210,13 +288,43 @@ int main(void) {
     communication.setThreadInsulinUnits(0);
     communication.setThreadGlucagonUnits(0);
     communication.setThreadEndThread(false);
+    // no simulation thread yet, so the first menu already shows the start values
+    communication.applyCommands();
+    communication.publishState(body->getBloodSugarLevel(), 0);
     
-    thread first_thread(Sim_Controll_Thread);
-    thread second_thread(BSL_Sim_thread);
-    
-    first_thread.join();
-    second_thread.join();
+    if (bench_cycles > 0) {
+        // the emulated pump replaces the interactive controller
+        quiet = true;
+        thread second_thread(BSL_Sim_thread);
+
+        Pump_Emu_thread(bench_cycles);
+        communication.setThreadEndThread(true);
+        if (socket_channel) {
+            socket_channel->wakeup();
+        }
+        second_thread.join();
+    }
+    else if (script) {
+        // the scenario file replaces the menu and ends the simulation
+        thread second_thread(BSL_Sim_thread);
+
+        second_thread.join();
+    }
+    else {
+        thread first_thread(Sim_Controll_Thread);
+        thread second_thread(BSL_Sim_thread);
+
+        first_thread.join();
+        second_thread.join();
+    }
     
+    delete ring_to_pump;
+    delete ring_to_body;
+    delete socket_channel;
+    delete script;
+    delete sample_log;
+    delete body;
+
     cout << "End\n";
     return 0;
 }
@@ -234,7 +342,12 @@ int Sim_Controll_Thread(void) {
     
     cout << "Body simulator for SCS-Project InsulinPump\nV1.0\n\n";
     
+    bodystate state;
+
     while (true) {
+        communication.getThreadState(&state);
+        cout << "Current BSL: " << state.bloodsugar_level << " after " << state.steps << " steps, body factor "
+             << state.body_factor << (state.rising ? " rising" : " falling") << "\n";
         cout << "Please set:\n" \
                 " 1: Eating a lot of sweets (BSL rising fast)\n" \
                 " 2: BSL Eating a snack (BSL rising moderate)\n" \
@@ -246,28 +359,14 @@ int Sim_Controll_Thread(void) {
         cin >> user_bsl_ris_fal;
         cout << "Your choice: " << user_bsl_ris_fal << endl << flush;
     
-        if (user_bsl_ris_fal == 1) {
-            communication.setThreadRising(true);
-            communication.setThreadBodyFactor(1.04);
-        }
-        else if (user_bsl_ris_fal == 2) {
-            communication.setThreadRising(true);
-            communication.setThreadBodyFactor(1.02);
-        }
-        else if (user_bsl_ris_fal == 3) {
-            communication.setThreadRising(false);
-            communication.setThreadBodyFactor(1.00);
-        }
-        else if (user_bsl_ris_fal == 4) {
-            communication.setThreadRising(false);
-            communication.setThreadBodyFactor(1.01);
-        }
-        else if (user_bsl_ris_fal == 5) {
-            communication.setThreadRising(false);
-            communication.setThreadBodyFactor(1.05);
+        if (apply_scenario(user_bsl_ris_fal)) {
+            // body factor changed
         }
         else if (user_bsl_ris_fal == 6) {
             communication.setThreadEndThread(true);
+            if (socket_channel) {
+                socket_channel->wakeup();
+            }
             break;
         }
         else {
@@ -279,6 +378,44 @@ int Sim_Controll_Thread(void) {
     
     return 0;
 }
+
+// Sets the body factor for one of the options 1-5 of the menu,
+// returns false for any other option
+bool apply_scenario(int option) {
+    float factor;
+    bool rising;
+
+    if (!ScenarioScript::getOption(option, &factor, &rising)) {
+        return false;
+    }
+    communication.setThreadRising(rising);
+    communication.setThreadBodyFactor(factor);
+    return true;
+}
+
+// Applies the events of the scenario file that are due after the given
+// number of steps, returns false once the file ends the simulation.
+// Only called by the simulation thread, there is no menu thread then.
+// Each event is applied before the next one is queued: this thread is the
+// only one draining the command queue, a full queue would never empty.
+bool run_script(uint64_t steps) {
+    const scenarioevent *event;
+
+    while ((event = script->next(steps)) != NULL) {
+        if (event->type == SCENARIO_END) {
+            communication.setThreadEndThread(true);
+            return false;
+        }
+        communication.setThreadRising(event->rising);
+        communication.setThreadBodyFactor(event->factor);
+        communication.applyCommands();
+        if (!quiet) {
+            cout << "\nScenario at " << steps * HOURS_PER_STEP << " h: body factor " << event->factor
+                 << (event->rising ? " rising" : " falling") << endl;
+        }
+    }
+    return true;
+}
 /******************************************************
  *            END Simulation-Controller               *
  ******************************************************/
@@ -289,12 +426,16 @@ int Sim_Controll_Thread(void) {
  ******************************************************/
 int BSL_Sim_thread(void) {
     int insulin_amount, glucagon_amount;
+    int received, status = WIRE_OK;
+    wireframe frame, buffer;
+    static float samples[HEADLESS_CHUNK];
+    uint64_t steps = 0;
 
     cout << "\nThread started\n";
     
-    ofstream logfile;
-    
-    cout << "Init value for BloodSugarLevel: " << body.getBloodSugarLevel() << endl;
+    cout << "Init value for BloodSugarLevel: " << body->getBloodSugarLevel() << endl;
+    communication.applyCommands();
+    communication.publishState(body->getBloodSugarLevel(), steps);
 
     
     while (true) {
@@ -302,15 +443,62 @@ int BSL_Sim_thread(void) {
         if (communication.getThreadEndThread() == true) {
             break;
         }
+
+        // scripted scenario changes are queued like the ones of the menu
+        if (script && !run_script(steps)) {
+            break;
+        }
+
+        // scenario changes of the control thread take effect between two steps
+        communication.applyCommands();
+
+        if (headless_steps > 0) {
+            // accelerated time: no pump to talk to, only the body reacts
+            long chunk = headless_steps < HEADLESS_CHUNK ? headless_steps : HEADLESS_CHUNK;
+            if (script && script->stepsUntilNext(steps) > 0 && script->stepsUntilNext(steps) < chunk) {
+                // a chunk ends where the next event is due
+                chunk = script->stepsUntilNext(steps);
+            }
+            int insulin_units = communication.getThreadInsulinUnits();
+            int glucagon_units = communication.getThreadGlucagonUnits();
+            body->simulateSteps(chunk, communication.getThreadBodyFactor(), communication.getThreadRising(),
+                                insulin_units, glucagon_units, samples);
+            communication.setThreadInsulinUnits(insulin_units);
+            communication.setThreadGlucagonUnits(glucagon_units);
+
+            for (long i = 0; i < chunk; i++) {
+                sample_log->write(samples[i]);
+            }
+            steps += chunk;
+            communication.publishState(samples[chunk - 1], steps);
+
+            headless_steps -= chunk;
+            if (headless_steps == 0) {
+                communication.setThreadEndThread(true);
+            }
+            continue;
+        }
         
         /******************************************************
          *      Communication between body and pump           *
          ******************************************************/
         
         // write Body --> Pump
-        ofstream out_pipe("pipe_to_pump", ios_base::out);
-        out_pipe << (int)body.getBloodSugarLevel();
-        out_pipe.close();
+        wire.encode(&frame, body->getBloodSugarLevel(), 0);
+        if (transport_mode == TRANSPORT_SHM) {
+            ring_to_pump->push(&frame, sizeof(frame));
+        }
+        else if (transport_mode == TRANSPORT_SOCKET) {
+            if (!socket_channel->waitConnected(-1)) {
+                continue;
+            }
+            socket_channel->send(&frame, sizeof(frame));
+        }
+        else {
+            ofstream out_pipe("pipe_to_pump", ios_base::out | ios_base::binary);
+            out_pipe.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+            out_pipe.close();
+        }
         
         if (communication.getThreadEndThread() == true) {
             break;
@@ -321,83 +509,71 @@ int BSL_Sim_thread(void) {
          ******************************************************/
         
         
-        // generate BSL graph by reacting or not reacting to insulin
-        if ((communication.getThreadInsulinUnits()) > 0 && communication.getThreadGlucagonUnits() == 0) {
-            body.changeBloodSugarLevel(communication.getThreadBodyFactor(), communication.getThreadRising(), true, false);
-            communication.minusThreadInsulinUnits(1);
-        }
-        
-        else if (communication.getThreadInsulinUnits() == 0 && communication.getThreadGlucagonUnits() == 0) {
-            body.changeBloodSugarLevel(communication.getThreadBodyFactor(), communication.getThreadRising(), false, false);
-        }
-        
-        // generate BSL graph by reacting or not reacting to glucagon
-        else if (communication.getThreadGlucagonUnits() > 0 && communication.getThreadInsulinUnits() == 0) {
-            body.changeBloodSugarLevel(communication.getThreadBodyFactor(), communication.getThreadRising(), false, true);
-            communication.minusThreadGlucagonUnits(1);
-        }
+        // generate BSL graph by reacting or not reacting to insulin/glucagon
+        int insulin_units = communication.getThreadInsulinUnits();
+        int glucagon_units = communication.getThreadGlucagonUnits();
+        body->simulateStep(communication.getThreadBodyFactor(), communication.getThreadRising(),
+                          insulin_units, glucagon_units);
+        communication.setThreadInsulinUnits(insulin_units);
+        communication.setThreadGlucagonUnits(glucagon_units);
+        communication.publishState(body->getBloodSugarLevel(), ++steps);
         
         
         /******************************************************
          *      Communication between body and pump           *
          ******************************************************/
 
-        // read Pump --> Body
-        ifstream in_pipe; // pipe_to_body
-        in_pipe.open("pipe_to_body", ios_base::in);
-        
-        while (!(in_pipe.good())) {
-            /*
-            cout << "Pipe not available!\nWaiting..." << endl;
-            */
-            in_pipe.close();
-            usleep(100000);
-            in_pipe.open("pipe_to_body", ios_base::in);
-        }
-        
-        if (in_pipe.good()) {
-            in_pipe.seekg(0, ios::beg);
-            in_pipe.read(symbols_insulin, 2);
-            in_pipe.seekg(2, ios::beg);
-            in_pipe.read(symbols_glucagon, 2);
-            
-            in_pipe.close();
-            
-            remove("pipe_to_body");
-
-            insulin_amount = atoi(symbols_insulin);
-            glucagon_amount = atoi(symbols_glucagon);
-            if( insulin_amount == 0 && glucagon_amount == 0 )
-            {
-                cout << "\rInjected Insulin: " << atoi(symbols_insulin)
-                     << ", Injected Glucagon: " << atoi(symbols_glucagon)
-                     << flush;
+        // read Pump --> Body, stale and corrupt frames are dropped
+        do {
+            received = receive_injection_frame(&buffer);
+            if (received <= 0) {
+                break;
             }
-            else
-            {
-                cout << "\rInjected Insulin: " << atoi(symbols_insulin)
-                     << ", Injected Glucagon: " << atoi(symbols_glucagon)
-                     << endl << flush;
-            }
-            fflush(stdout);
+            status = wire.decode(&buffer, received, &frame);
+        } while (status == WIRE_STALE || status == WIRE_CORRUPT);
 
-            communication.setThreadInsulinUnits(atoi(symbols_insulin));
-            communication.setThreadGlucagonUnits(atoi(symbols_glucagon));
-            
+        if (communication.getThreadEndThread() == true) {
+            break;
         }
-        else {
-            cout << "Communication is not possible, broken pipe!\n";
+        if (received <= 0) {
+            // pump went away or reconnected, send the reading again
+            continue;
+        }
+        if (status == WIRE_LOST && !quiet) {
+            cout << "\nInjection frames lost: " << wire.getLostFrames() << endl;
+        }
+
+        insulin_amount = (int)lround(WireProtocol::getValue(frame.value));
+        glucagon_amount = (int)lround(WireProtocol::getValue(frame.value2));
+
+        if( quiet )
+        {
+            // benchmark, keep the console out of the measurement
+        }
+        else if( insulin_amount == 0 && glucagon_amount == 0 )
+        {
+            cout << "\rInjected Insulin: " << insulin_amount
+                 << ", Injected Glucagon: " << glucagon_amount
+                 << flush;
+            fflush(stdout);
         }
-         
+        else
+        {
+            cout << "\rInjected Insulin: " << insulin_amount
+                 << ", Injected Glucagon: " << glucagon_amount
+                 << endl << flush;
+            fflush(stdout);
+        }
+
+        communication.setThreadInsulinUnits(insulin_amount);
+        communication.setThreadGlucagonUnits(glucagon_amount);
+
         /******************************************************
          *       End Communication between body and pump      *
          ******************************************************/
 
 
-        logfile.open("log.txt", ios::out | ios::app);
-        logfile << body.getBloodSugarLevel();
-        logfile << "\n";
-        logfile.close();
+        sample_log->write(body->getBloodSugarLevel());
         //usleep(100000);
 
     }
@@ -409,4 +585,208 @@ int BSL_Sim_thread(void) {
  ******************************************************/
 
 
+/******************************************************
+ *                Population-Simulator                *
+ ******************************************************/
+// Runs a whole cohort headless with the selected scenario, the patients get
+// spread start levels and pending units. The first ones are checked against
+// single Body objects.
+int Population_Sim(long steps, int patients) {
+    float factor = communication.getThreadBodyFactor();
+    bool rising = communication.getThreadRising();
+    BodyPopulation population(patients, 110.00, 5, 5);
+    int checked = patients < POPULATION_CHECK ? patients : POPULATION_CHECK;
+    bool match = true;
+
+    for (int i = 0; i < patients; i++) {
+        population.setBody(i, 80.00 + (i % 100), factor, rising);
+        population.setUnits(i, (i % 3 == 1) ? i % 7 : 0, (i % 3 == 2) ? i % 5 : 0);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    population.simulate(steps);
+    double wall_s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < checked; i++) {
+        Body reference(80.00 + (i % 100), 5, 5);
+        int insulin_units = (i % 3 == 1) ? i % 7 : 0;
+        int glucagon_units = (i % 3 == 2) ? i % 5 : 0;
+        for (long step = 0; step < steps; step++) {
+            reference.simulateStep(factor, rising, insulin_units, glucagon_units);
+        }
+        if (reference.getBloodSugarLevel() != population.getBloodSugarLevel(i)) {
+            cout << "Patient " << i << ": BSL " << population.getBloodSugarLevel(i)
+                 << ", single Body " << reference.getBloodSugarLevel() << " (MISMATCH)\n";
+            match = false;
+        }
+    }
+
+    double sim_hours = steps * HOURS_PER_STEP;
+    cout << "Population simulation: " << patients << " patients, " << sim_hours
+         << " simulated hours (" << steps << " steps) in " << wall_s << " s\n"
+         << "Throughput: " << (wall_s > 0 ? sim_hours * patients / wall_s : 0)
+         << " simulated patient hours per wall second\n"
+         << "First " << checked << " patients " << (match ? "match" : "do NOT match")
+         << " the single Body simulation" << endl;
+
+    return match ? 0 : EXIT__FAILURE;
+}
+/******************************************************
+ *              END Population-Simulator              *
+ ******************************************************/
+
+
+/******************************************************
+ *                Injection-Receiver                  *
+ ******************************************************/
+// Waits for the next injection frame from the pump, returns its size,
+// 0 on end of simulation and -1 if the pump went away or reconnected
+int receive_injection_frame(wireframe *buffer) {
+
+    if (transport_mode == TRANSPORT_SHM) {
+        // a fast pump answers within the spin, a slow one is polled
+        chrono::steady_clock::time_point spin_end = chrono::steady_clock::now() + chrono::microseconds(SHM_SPIN_USEC);
+        while (!ring_to_body->pop(buffer, sizeof(wireframe))) {
+            if (communication.getThreadEndThread() == true) {
+                return 0;
+            }
+            if (chrono::steady_clock::now() < spin_end) {
+                this_thread::yield();
+            }
+            else {
+                usleep(SHM_POLL_USEC);
+            }
+        }
+        return sizeof(wireframe);
+    }
+    else if (transport_mode == TRANSPORT_SOCKET) {
+        // blocks in epoll until the pump answers, a signal or wakeup does
+        // not skip the injection of this reading
+        while (true) {
+            int received = socket_channel->receive(buffer, sizeof(wireframe), -1);
+            if (received != 0 && received != CHANNEL_WOKEN) {
+                return received;
+            }
+            if (communication.getThreadEndThread() == true) {
+                return 0;
+            }
+        }
+    }
+
+    while (true) {
+        ifstream in_pipe("pipe_to_body", ios_base::in | ios_base::binary);
+
+        // the pump may still be writing, wait for the whole frame
+        if (in_pipe.good()) {
+            in_pipe.read(reinterpret_cast<char*>(buffer), sizeof(wireframe));
+            if (in_pipe.gcount() == sizeof(wireframe)) {
+                in_pipe.close();
+                remove("pipe_to_body");
+                return sizeof(wireframe);
+            }
+        }
+        in_pipe.close();
+
+        if (communication.getThreadEndThread() == true) {
+            return 0;
+        }
+        usleep(100000);
+    }
+}
+/******************************************************
+ *              END Injection-Receiver                *
+ ******************************************************/
+
+
+/******************************************************
+ *                  Pump-Emulator                     *
+ ******************************************************/
+// Plays the pump side of the selected transport as fast as possible and
+// measures the round trip from sending an injection to the next reading
+int Pump_Emu_thread(int cycles) {
+    SharedMemoryRing *emu_from_body = NULL;
+    SharedMemoryRing *emu_to_body = NULL;
+    UnixSocketChannel *emu_channel = NULL;
+    WireProtocol emu_wire(WIRE_INJECTION, WIRE_SENSOR);
+    wireframe frame, reading;
+    double min_us = 1e12, max_us = 0, sum_us = 0;
+
+    if (transport_mode == TRANSPORT_SHM) {
+        emu_from_body = new SharedMemoryRing(SHM_RING_TO_PUMP, false);
+        emu_to_body = new SharedMemoryRing(SHM_RING_TO_BODY, false);
+    }
+    else if (transport_mode == TRANSPORT_SOCKET) {
+        emu_channel = new UnixSocketChannel(SOCKET_PATH, false);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    chrono::steady_clock::time_point sent = start;
+
+    for (int i = 0; i <= cycles; i++) {
+
+        // read Body --> Pump
+        if (transport_mode == TRANSPORT_SHM) {
+            while (!emu_from_body->pop(&frame, sizeof(frame))) {
+                this_thread::yield();
+            }
+        }
+        else if (transport_mode == TRANSPORT_SOCKET) {
+            while (emu_channel->receive(&frame, sizeof(frame), -1) <= 0) {
+                // (re)connecting
+            }
+        }
+        else {
+            while (true) {
+                ifstream in_pipe("pipe_to_pump", ios_base::in | ios_base::binary);
+                if (in_pipe.good() && in_pipe.read(reinterpret_cast<char*>(&frame), sizeof(frame))) {
+                    break;
+                }
+                usleep(50);
+            }
+            remove("pipe_to_pump");
+        }
+        emu_wire.decode(&frame, sizeof(frame), &reading);
 
+        if (i > 0) {
+            double us = chrono::duration<double, micro>(chrono::steady_clock::now() - sent).count();
+            sum_us += us;
+            min_us = us < min_us ? us : min_us;
+            max_us = us > max_us ? us : max_us;
+        }
+        if (i == cycles) {
+            break;
+        }
+
+        // write Pump --> Body
+        sent = chrono::steady_clock::now();
+        emu_wire.encode(&frame, 0, 0);
+        if (transport_mode == TRANSPORT_SHM) {
+            emu_to_body->push(&frame, sizeof(frame));
+        }
+        else if (transport_mode == TRANSPORT_SOCKET) {
+            emu_channel->send(&frame, sizeof(frame));
+        }
+        else {
+            ofstream out_pipe("pipe_to_body", ios_base::out | ios_base::binary);
+            out_pipe.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+            out_pipe.close();
+        }
+    }
+
+    double total_s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "\nTransport benchmark: " << cycles << " cycles in " << total_s << " s ("
+         << cycles / total_s << " cycles/s)\n"
+         << "Round trip injection -> reading [us]: min " << min_us
+         << ", avg " << sum_us / cycles << ", max " << max_us << "\n"
+         << "Sensor frames lost: " << emu_wire.getLostFrames()
+         << ", stale: " << emu_wire.getStaleFrames()
+         << ", corrupt: " << emu_wire.getCorruptFrames() << endl;
+
+    delete emu_from_body;
+    delete emu_to_body;
+    delete emu_channel;
+    return 0;
+}
+/******************************************************
+ *                END Pump-Emulator                   *
+ ******************************************************/
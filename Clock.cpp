@@ -0,0 +1,94 @@
+/**
+ * @file:   Clock.cpp
+ * @class:  Clock, RealClock, SimulatedClock
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Time source of the control stack
+ *          Wall time or discrete simulated time
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "Clock.h"
+
+using namespace std;
+
+
+
+/* The wall time clock, created on first use
+ */
+Clock *Clock::getRealClock()
+{
+    static RealClock Real;
+
+    return &Real;
+}
+
+
+/* Wall time
+ */
+chrono::steady_clock::time_point RealClock::now()
+{
+    return chrono::steady_clock::now();
+}
+
+QDateTime RealClock::currentDateTime()
+{
+    return QDateTime::currentDateTime();
+}
+
+bool RealClock::isSimulated() const
+{
+    return false;
+}
+
+bool RealClock::advanceTo(chrono::steady_clock::time_point)
+{
+    return false;
+}
+
+
+/* The simulated time starts at 0
+ */
+SimulatedClock::SimulatedClock(QDateTime start) :
+    Start(start),
+    Elapsed(0)
+{
+}
+
+chrono::steady_clock::time_point SimulatedClock::now()
+{
+    return chrono::steady_clock::time_point(chrono::microseconds(Elapsed.load()));
+}
+
+QDateTime SimulatedClock::currentDateTime()
+{
+    return Start.addMSecs(Elapsed.load() / 1000);
+}
+
+bool SimulatedClock::isSimulated() const
+{
+    return true;
+}
+
+/* Forward only, a later time from another thread wins
+ */
+bool SimulatedClock::advanceTo(chrono::steady_clock::time_point time)
+{
+    int64_t target = chrono::duration_cast<chrono::microseconds>(time.time_since_epoch()).count();
+    int64_t elapsed = Elapsed.load();
+
+    while(target > elapsed)
+    {
+        if(Elapsed.compare_exchange_weak(elapsed, target))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file:   Clock.h
+ * @class:  Clock, RealClock, SimulatedClock
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Time source of the control stack
+ *          Wall time or discrete simulated time
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef clock_
+#define clock_
+
+#include <QDateTime>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+
+
+class Clock
+{
+    public:
+        virtual ~Clock() {}
+
+        /**
+         * @name:   Now
+         * @brief:  The monotonic time
+         *
+         * @return: The current point of the monotonic time
+         */
+        virtual std::chrono::steady_clock::time_point now() = 0;
+
+        /**
+         * @name:   Current Date Time
+         * @brief:  The calendar time, for timestamps
+         *
+         * @return: The current date & time
+         */
+        virtual QDateTime currentDateTime() = 0;
+
+        /**
+         * @name:   Is Simulated
+         * @brief:  Checks if the time only moves by advanceTo()
+         *
+         * @return: When the time is simulated, 'true' is returned
+         */
+        virtual bool isSimulated() const = 0;
+
+        /**
+         * @name:   Advance To
+         * @brief:  Moves the simulated time forward, never back
+         *
+         * @param:  The new point of the monotonic time
+         * @return: When the time could be moved, 'true' is returned
+         */
+        virtual bool advanceTo(std::chrono::steady_clock::time_point time) = 0;
+
+        /**
+         * @name:   Get Real Clock
+         * @brief:  The wall time clock shared by everyone
+         *
+         * @return: A pointer to the real clock
+         */
+        static Clock *getRealClock();
+};
+
+
+
+class RealClock : public Clock
+{
+    public:
+        /**
+         * @name:   Now / Current Date Time
+         * @brief:  std::chrono::steady_clock / QDateTime::currentDateTime()
+         */
+        virtual std::chrono::steady_clock::time_point now();
+        virtual QDateTime currentDateTime();
+
+        /**
+         * @name:   Is Simulated / Advance To
+         * @brief:  Wall time can not be advanced, 'false' is returned
+         */
+        virtual bool isSimulated() const;
+        virtual bool advanceTo(std::chrono::steady_clock::time_point time);
+};
+
+
+
+class SimulatedClock : public Clock
+{
+    public:
+        /**
+         * @name:   Simulated Clock
+         * @brief:  Simulated Clock Constructor
+         *
+         *  The monotonic time starts at 0, the calendar time at the
+         *  given date & time
+         *
+         * @param:  The calendar time of the start
+         */
+        SimulatedClock(QDateTime start);
+
+        /**
+         * @name:   Now / Current Date Time
+         * @brief:  The time of the last advance
+         */
+        virtual std::chrono::steady_clock::time_point now();
+        virtual QDateTime currentDateTime();
+
+        /**
+         * @name:   Is Simulated / Advance To
+         * @brief:  Only moves forward, may be called from any thread
+         */
+        virtual bool isSimulated() const;
+        virtual bool advanceTo(std::chrono::steady_clock::time_point time);
+
+    private:
+        /**
+         * @name:   Start / Elapsed
+         * @brief:  Calendar time of the start / simulated time since in us
+         */
+        QDateTime Start;
+        std::atomic<int64_t> Elapsed;
+};
+
+#endif
@@ -15,6 +15,13 @@
 #define config_
 
 
+// Pump <-> Body transports
+#define TRANSPORT_FILE      0   // pipe_to_pump / pipe_to_body files
+#define TRANSPORT_SHM       1   // shared memory rings
+#define TRANSPORT_SOCKET    2   // unix domain socket
+#define TRANSPORT_INPROCESS 3   // body model linked into the pump
+
+
 /**
  * @name        Configuration
  * @brief       A structure for the system configuration
@@ -33,7 +40,18 @@
  *  BattCrit    Battery Critical Level
  *  MaxOpTime   Maximum Operation Time (h)
  *  SchedInt    Scheduler Interval (sec)
+ *  SchedIntMs  Scheduler Interval (ms), SchedInt * 1000 if not given
+ *  Adaptive    Adapt the scheduler interval to the BSL & battery (0/1)
+ *  SchedMinMs  Shortest adaptive scheduler interval (ms)
+ *  SchedMaxMs  Longest adaptive scheduler interval (ms)
+ *  AdaptRate   BSL change per scheduler interval that counts as fast (mg/dL)
+ *  Tickless    One timer loop wakes the scheduler threads (0/1)
+ *  CpuAffinity CPU of the pump cycle thread, -1 for any
+ *  RtPriority  SCHED_FIFO priority of the pump cycle thread, 0 for none
+ *  LockMemory  Lock the memory of the process into RAM (0/1)
  *  ContrInt    Controller Interval (sec)
+ *  Transport   Pump <-> Body Transport (TRANSPORT_*)
+ *  Record      Record the pump cycles to the trace file (0/1)
  */
 struct config{
     int hsf;
@@ -50,9 +68,21 @@ struct config{
     int battCrit;
     int maxOpTime;
     int schedInt;
+    int schedIntMs;
+    int adaptive;
+    int schedMinMs;
+    int schedMaxMs;
+    int adaptRate;
+    int tickless;
+    int cpuAffinity;
+    int rtPriority;
+    int lockMemory;
     int contrInt;
+    int transport;
+    int record;
 };
 
+
 #endif
 
 
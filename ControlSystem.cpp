@@ -15,6 +15,10 @@
 
 
 #include "ControlSystem.h"
+#include "FileTransport.h"
+#include "InProcessTransport.h"
+#include "SharedMemoryTransport.h"
+#include "SocketTransport.h"
 
 using namespace std;
 
@@ -23,29 +27,158 @@ using namespace std;
 /* The constructor instantiates all necessary objects
  * and connects some signals to slot for the user interface
  */
-ControlSystem::ControlSystem(UserInterface* ui)
+ControlSystem::ControlSystem(UserInterface* ui, Clock *clock)
 {
     // Initialise variables & objects
     SchouldRun = true;
-
-    TheTracer = new Tracer();
-
-    if(readConfiguration(CONFIGFILE_NAME))
-    {
-        ui->init(Configuration);
-        ThePump = new Pump(TheTracer, Configuration);
-        TheScheduler = new Scheduler(ThePump, Configuration);
+    MissedDeadlines = 0;
+    TheClock = clock ? clock : Clock::getRealClock();
+    TheBody = NULL;
+    TheRecorder = NULL;
+
+    TheTracer = new Tracer(TheClock);
+
+    bool configured = readConfiguration(CONFIGFILE_NAME);
+    if(configured && TheClock->isSimulated() && Configuration.transport != TRANSPORT_INPROCESS)
+    {
+        // a Body process would run on the real clock
+        TheTracer->writeWarningLog("Simulated time, the body runs in process");
+        Configuration.transport = TRANSPORT_INPROCESS;
+    }
+
+    if(configured &&
+       createTransport(Configuration.transport, &TheSensorTransport, &TheInjectionTransport, &TheBody))
+    {
+        if(ui)
+        {
+            ui->init(Configuration);
+            ui->setClock(TheClock);
+        }
+        ThePump = new Pump(TheTracer, Configuration, TheSensorTransport, TheInjectionTransport);
+        if(Configuration.record)
+        {
+            TheRecorder = new TraceRecorder(TRACE_FILE_NAME);
+            if(TheRecorder->isValid())
+            {
+                ThePump->setRecorder(TheRecorder);
+            }
+            else
+            {
+                TheTracer->writeWarningLog("Could not create the trace file, not recording!");
+                delete TheRecorder;
+                TheRecorder = NULL;
+            }
+        }
+        TheScheduler = new Scheduler(ThePump, Configuration, TheClock);
     }
     else
     {
         TheTracer->writeCriticalLog("Problem parsing the configuration file! Exiting...");
-        QMessageBox msgBox;
-        msgBox.setText("Problem parsing the configuration file!\nIs it in path?\nExiting...");
-        msgBox.exec();
+        if(ui)
+        {
+            QMessageBox msgBox;
+            msgBox.setText("Problem parsing the configuration file!\nIs it in path?\nExiting...");
+            msgBox.exec();
+        }
         exit(EXIT_FAILURE);
     }
 
     // Initialise callbacks for user interface
+    if(ui)
+    {
+        connectUserInterface(ui);
+    }
+
+    // Health checks, below the pump cycle on the threads of the scheduler:
+    // run by the events, polling only as a backstop, except for stalls &
+    // the operation time, which has no event and only advances when checked
+    int period = Configuration.contrInt * 1000;
+    BatteryCheck = TheScheduler->addJob("battery", [this]() { if(SchouldRun) checkBatteryStatus(); },
+                                        period * CONTROL_BACKSTOP_FACTOR, SCHEDULER_PRIORITY_SERVICE, 0);
+    CheckJobs.push_back(BatteryCheck);
+    OperationCheck = TheScheduler->addJob("operation hours", [this]() { if(SchouldRun) checkOperationHours(); },
+                                          period, SCHEDULER_PRIORITY_SERVICE, 0);
+    PumpCheck = TheScheduler->addJob("pump", [this]() { if(SchouldRun) checkPump(); },
+                                     period * CONTROL_BACKSTOP_FACTOR, SCHEDULER_PRIORITY_SERVICE, 0);
+    CheckJobs.push_back(PumpCheck);
+    SchedulerCheck = TheScheduler->addJob("scheduler", [this]() { if(SchouldRun) checkScheduler(); },
+                                          period, SCHEDULER_PRIORITY_SERVICE, 0);
+    TracerCheck = TheScheduler->addJob("tracer", [this]() { if(SchouldRun) checkTracer(); },
+                                       period * CONTROL_BACKSTOP_FACTOR, SCHEDULER_PRIORITY_SERVICE, 0);
+    CheckJobs.push_back(TracerCheck);
+
+    // Alarms, notified on transitions only
+    TheAlarms = new AlarmEngine(TheTracer, TheClock);
+    BatteryAlarm = TheAlarms->addAlarm("battery", false, Configuration.battWarn, Configuration.battCrit,
+                                       ALARM_HYSTERESIS_BATTERY,
+                                       "The batteries charging state (%1%) is getting low (warning at %2%).",
+                                       "The batteries charging state (%1%) is beyond minimum (%2%).");
+    // the pump status counts a reservoir below its level
+    InsulinAlarm = TheAlarms->addAlarm("insulin reservoir", false, Configuration.resWarn - 1,
+                                       Configuration.resCrit - 1, ALARM_HYSTERESIS_RESERVOIR,
+                                       "Pump status: the insulin amount is getting low (%1)!",
+                                       "Pump status: the insulin fill level is very low (%1)!");
+    GlucagonAlarm = TheAlarms->addAlarm("glucagon reservoir", false, Configuration.resWarn - 1,
+                                        Configuration.resCrit - 1, ALARM_HYSTERESIS_RESERVOIR,
+                                        "Pump status: the glucagon amount is getting low (%1)!",
+                                        "Pump status: the glucagon fill level is very low (%1)!");
+    OperationAlarm = TheAlarms->addAlarm("operation time", true, nearMaxOperationHours(Configuration.maxOpTime),
+                                         Configuration.maxOpTime, 0,
+                                         "The actual operation time (%1h) is near maximum (%3h).",
+                                         "The maximum operation time (%2h) is reached (%1h).");
+    // only logged, as the pump always did
+    HighBslAlarm = TheAlarms->addAlarm("high blood sugar", true, Configuration.upperAlarm,
+                                       Configuration.upperAlarm, ALARM_HYSTERESIS_BSL,
+                                       "Pump: Blood sugar level is getting high (%1 mg/dL, alarm at %3 mg/dL)!",
+                                       "Pump: High blood sugar level (%1 mg/dL)!", false);
+    LowBslAlarm = TheAlarms->addAlarm("low blood sugar", false, Configuration.lowerAlarm,
+                                      Configuration.lowerAlarm, ALARM_HYSTERESIS_BSL,
+                                      "Pump: Blood sugar level is getting low (%1 mg/dL, alarm at %3 mg/dL)!",
+                                      "Pump: Low blood sugar level (%1 mg/dL)!", false);
+
+    // Events, on the thread that caused them
+    BatteryBand = BATTERY_BAND_OK;
+    QObject::connect(ThePump, SIGNAL(batteryLevelChanged(int)), this, SLOT(batteryLevelChanged(int)), Qt::DirectConnection);
+    QObject::connect(ThePump, SIGNAL(pumpStatusChanged(int)), this, SLOT(pumpStatusChanged(int)), Qt::DirectConnection);
+    QObject::connect(TheTracer, SIGNAL(statusChanged(int)), this, SLOT(tracerStatusChanged(int)), Qt::DirectConnection);
+    QObject::connect(TheScheduler, SIGNAL(deadlineMissed()), this, SLOT(deadlineMissed()), Qt::DirectConnection);
+    QObject::connect(ThePump, SIGNAL(updateBloodSugarLevel(int)), this, SLOT(bloodSugarLevelChanged(int)), Qt::DirectConnection);
+    TheScheduler->addJob("diagnostics", [this]() { if(SchouldRun) reportDiagnostics(); },
+                         SCHEDULER_DIAGNOSTICS_MS, SCHEDULER_PRIORITY_SERVICE, 0);
+    TheScheduler->addJob("statistics", [this]() { if(SchouldRun) reportStatistics(); },
+                         SCHEDULER_STATISTICS_MS, SCHEDULER_PRIORITY_SERVICE, 0);
+
+    // Let objects do their initialisation
+    ThePump->initPump();
+}
+
+/* The destructor stops the jobs, which use all the other objects,
+ * and deletes them in reverse order of their use
+ */
+ControlSystem::~ControlSystem()
+{
+    // the executor threads are joined, no check or cycle runs after this
+    SchouldRun = false;
+    TheScheduler->setSchouldRun(false);
+
+    // Operation time up to now, the journal commits it on deletion
+    TheScheduler->getOperationTime();
+    TheScheduler->saveOperationTime();
+    delete TheScheduler;
+
+    delete TheAlarms;
+    delete ThePump;
+    delete TheRecorder;
+    delete TheSensorTransport;
+    delete TheBody;
+    delete TheTracer;
+}
+
+
+/* Connects the signals & slots of the user interface
+ */
+void ControlSystem::connectUserInterface(UserInterface* ui)
+{
     QObject::connect(ThePump, SIGNAL(updateBatteryPowerLevel(int)), ui, SLOT(batteryPowerLevelChanged(int)));
     QObject::connect(ui, SIGNAL(setBatteryPowerLevel(int)), ThePump, SLOT(changeBatteryPowerLevel(int)));
     QObject::connect(ThePump, SIGNAL(updateInsulinReservoir(int)), ui, SLOT(insulinAmountInReservoirChanged(int)));
@@ -72,9 +205,7 @@ ControlSystem::ControlSystem(UserInterface* ui)
     QObject::connect(ui, SIGNAL(setMaxOperationTime(int)), this, SLOT(setMaxOperationHours(int)));
     QObject::connect(this, SIGNAL(updateControlThreadInterval(int)), ui, SLOT(controlThreadIntervalChanged(int)));
     QObject::connect(ui, SIGNAL(setControlThreadInterval(int)), this, SLOT(setIntervalSec(int)));
-
-    // Let objects do their initialisation
-    ThePump->initPump();
+    QObject::connect(this, SIGNAL(updateDiagnostics(QStringList)), ui, SLOT(updateDiagnostics(QStringList)));
 }
 
 
@@ -93,20 +224,7 @@ int ControlSystem::checkOperationHours()
     }
 
     int OperationHours = OperationTime/3600000;
-    if(OperationHours >= Configuration.maxOpTime)
-    {
-        QString msg = "The maximum operation time (" + QString::number(Configuration.maxOpTime)
-                    + "h) is reached (" + QString::number(OperationHours) + "h).";
-        TheTracer->writeCriticalLog(msg);
-        TheTracer->playAcousticWarning();
-        TheTracer->vibrationWarning();
-    }
-    else if(OperationHours >= (Configuration.maxOpTime*0.9))
-    {
-        QString msg = "The actual operation time (" + QString::number(Configuration.maxOpTime) +
-                      "h) is near maximum (" + QString::number(OperationHours) + "h).";
-        TheTracer->writeWarningLog(msg);
-    }
+    TheAlarms->update(OperationAlarm, OperationHours);
 
     return OperationHours;
 }
@@ -117,6 +235,27 @@ bool ControlSystem::checkScheduler()
 {
     QString msg = "";
 
+    QString realtime = TheScheduler->getRealTimeProblems();
+    if(realtime != RealTimeProblems)
+    {
+        if(!realtime.isEmpty())
+        {
+            TheTracer->writeWarningLog("The scheduler runs without some real-time settings: " +
+                                       realtime + ".");
+        }
+        RealTimeProblems = realtime;
+    }
+
+    quint64 missed = TheScheduler->getMissedDeadlines();
+    if(missed != MissedDeadlines)
+    {
+        msg = "The scheduler missed " + QString::number(missed - MissedDeadlines) +
+              " deadline(s), " + QString::number(missed) + " of " +
+              QString::number(TheScheduler->getCycles() + missed) + " in total.";
+        TheTracer->writeWarningLog(msg);
+        MissedDeadlines = missed;
+    }
+
     switch(TheScheduler->getStatus())
     {
         case 0: return true;
@@ -124,10 +263,13 @@ bool ControlSystem::checkScheduler()
                       "the timer is not valid!";
                 break;
         case 2: msg = "The scheduler is in a critical state: " \
-                      "the thread is not valid!";
+                      "the executor is not running!";
                 break;
         case 3: msg = "The scheduler is in a critical state: " \
-                      "the thread is not joinable!";
+                      "the executor lost threads!";
+                break;
+        case 4: msg = "The scheduler is in a critical state: " \
+                      "the pump cycle is stalled!";
                 break;
         default:msg = "The scheduler is in a critical state: " \
                       "unexpected behavior!";
@@ -144,44 +286,10 @@ bool ControlSystem::checkScheduler()
  */
 bool ControlSystem::checkPump()
 {
-    int Status = ThePump->getPumpStatus();
-    QString msg = "";
-
-    if(Status == 0)
-    {
-        return true;
-    }
+    TheAlarms->update(InsulinAlarm, ThePump->getInsulinReservoirLevel());
+    TheAlarms->update(GlucagonAlarm, ThePump->getGlucagonReservoirLevel());
 
-    if(Status & 1)
-    {
-        msg = "Pump status: " \
-              "the insulin fill level is very low!";
-        TheTracer->writeCriticalLog(msg);
-        TheTracer->playAcousticWarning();
-        TheTracer->vibrationWarning();
-    }
-    if(Status & 2)
-    {
-        msg = "Pump status: " \
-              "the insulin amount is getting low!";
-        TheTracer->writeWarningLog(msg);
-    }
-    if(Status & 4)
-    {
-        msg = "Pump status: " \
-              "the glucagon fill level is very low!";
-        TheTracer->writeCriticalLog(msg);
-        TheTracer->playAcousticWarning();
-        TheTracer->vibrationWarning();
-    }
-    if(Status & 8)
-    {
-        msg = "Pump status: " \
-              "the glucagon amount is getting low!";
-        TheTracer->writeWarningLog(msg);
-    }
-
-    return false;
+    return ThePump->getPumpStatus() == 0;
 }
 
 /* Checks the tracer
@@ -204,26 +312,48 @@ bool ControlSystem::checkTracer()
     return false;
 }
 
-/* Checks the batteries charging state
+/* Reports the histograms of all jobs to the UI
  */
-int ControlSystem::checkBatteryStatus()
+void ControlSystem::reportDiagnostics()
 {
-    int BatteryStatus = ThePump->getBatteryPowerLevel();
+    emit updateDiagnostics(TheScheduler->getStatistics());
+}
 
-    if(BatteryStatus <= Configuration.battCrit)
+/* Reports the histograms of the pump cycle to the log
+ */
+void ControlSystem::reportStatistics()
+{
+    histogramsummary lateness, execution;
+    TheScheduler->getCycleStatistics(&lateness, &execution);
+    if(lateness.count == 0)
     {
-        QString msg = "The batteries charging state (" + QString::number(BatteryStatus)
-                    + "%) is beyond minimum (" + QString::number(Configuration.battCrit) + "%).";
-        TheTracer->writeCriticalLog(msg);
-        TheTracer->playAcousticWarning();
-        TheTracer->vibrationWarning();
+        return;
     }
-    else if(BatteryStatus <= Configuration.battWarn)
+
+    QString msg = QString("Pump cycle latency after %1 cycles: late p50/p99/p999/max "
+                          "%2/%3/%4/%5 us, exec p50/p99/p999/max %6/%7/%8/%9 us")
+                  .arg(lateness.count)
+                  .arg(lateness.p50).arg(lateness.p99).arg(lateness.p999).arg(lateness.max)
+                  .arg(execution.p50).arg(execution.p99).arg(execution.p999).arg(execution.max);
+    TheTracer->writeStatusLog(msg);
+
+    // wall time rates, meaningless in simulated time
+    if(!TheClock->isSimulated())
     {
-        QString msg = "The batteries charging state (" + QString::number(BatteryStatus)
-                    + "%) is getting low (min:" + QString::number(Configuration.battCrit)+ "%).";
-        TheTracer->writeWarningLog(msg);
+        double wakeups, cpu;
+        TheScheduler->getIdleStatistics(&wakeups, &cpu);
+        TheTracer->writeStatusLog(QString("Scheduler %1: %2 wake-ups/min, %3 % CPU")
+                                  .arg(TheScheduler->isTickless() ? "tickless" : "ticking")
+                                  .arg(wakeups, 0, 'f', 1).arg(cpu, 0, 'f', 2));
     }
+}
+
+/* Checks the batteries charging state
+ */
+int ControlSystem::checkBatteryStatus()
+{
+    int BatteryStatus = ThePump->getBatteryPowerLevel();
+    TheAlarms->update(BatteryAlarm, BatteryStatus);
 
     return BatteryStatus;
 }
@@ -235,6 +365,20 @@ Scheduler* ControlSystem::getScheduler()
     return TheScheduler;
 }
 
+/* Returns the alarms of the checks
+ */
+AlarmEngine* ControlSystem::getAlarms()
+{
+    return TheAlarms;
+}
+
+/* Warning level of the operation time: 90 %, rounded up
+ */
+int ControlSystem::nearMaxOperationHours(int hours)
+{
+    return (hours * 9 + 9) / 10;
+}
+
 
 /* Getter & Setter for minumum Bettery load level in percent
  */
@@ -247,6 +391,7 @@ int ControlSystem::getBatteryMinLoad() const
 void ControlSystem::setBatteryMinLoad(int load)
 {
     Configuration.battCrit = load;
+    TheAlarms->setLevels(BatteryAlarm, Configuration.battWarn, load);
 
     emit updateMinBatteryLevel(load);
 }
@@ -262,6 +407,7 @@ int ControlSystem::getMaxOperationHours() const
 void ControlSystem::setMaxOperationHours(int hours)
 {
     Configuration.maxOpTime = hours;
+    TheAlarms->setLevels(OperationAlarm, nearMaxOperationHours(hours), hours);
 
     emit updateMaxOperationTime(hours);
 }
@@ -289,15 +435,62 @@ int ControlSystem::getIntervalSec() const
 void ControlSystem::setIntervalSec(int seconds)
 {
     Configuration.contrInt = seconds;
+    for(size_t i = 0; i < CheckJobs.size(); i++)
+    {
+        TheScheduler->setJobPeriod(CheckJobs[i], seconds * 1000 * CONTROL_BACKSTOP_FACTOR);
+    }
+    TheScheduler->setJobPeriod(SchedulerCheck, seconds * 1000);
+    TheScheduler->setJobPeriod(OperationCheck, seconds * 1000);
 
     emit updateControlThreadInterval(seconds);
 }
 
+/* Events (SLOTS), directly connected: only the check jobs are triggered
+ */
+void ControlSystem::batteryLevelChanged(int level)
+{
+    int band = level <= Configuration.battCrit ? BATTERY_BAND_CRIT :
+               level <= Configuration.battWarn ? BATTERY_BAND_WARN : BATTERY_BAND_OK;
+
+    if(BatteryBand.exchange(band) != band)
+    {
+        TheScheduler->triggerJob(BatteryCheck);
+    }
+}
+
+void ControlSystem::pumpStatusChanged(int)
+{
+    TheScheduler->triggerJob(PumpCheck);
+}
+
+void ControlSystem::tracerStatusChanged(int)
+{
+    TheScheduler->triggerJob(TracerCheck);
+}
+
+void ControlSystem::deadlineMissed()
+{
+    TheScheduler->triggerJob(SchedulerCheck);
+}
+
+void ControlSystem::bloodSugarLevelChanged(int level)
+{
+    TheAlarms->update(HighBslAlarm, level);
+    TheAlarms->update(LowBslAlarm, level);
+}
+
 
 
 /* Reads the configuration file
  */
 bool ControlSystem::readConfiguration(QString filename)
+{
+    return loadConfiguration(filename, &Configuration);
+}
+
+/* Reads the static configuration, also without a control system
+ */
+bool ControlSystem::loadConfiguration(QString filename, config *cfg)
 {
     QFileInfo checkFile(filename);
     if(!checkFile.exists())
@@ -305,89 +498,155 @@ bool ControlSystem::readConfiguration(QString filename)
         return false;
     }
 
-    SaveFile = new QSettings(filename, QSettings::NativeFormat);
+    QSettings SaveFile(filename, QSettings::NativeFormat);
 
-    if(!SaveFile->status() == QSettings::NoError)
+    if(!SaveFile.status() == QSettings::NoError)
     {
         return false;
     }
 
-    SaveFile->beginGroup( "InsulinPump-Static" );
+    SaveFile.beginGroup( "InsulinPump-Static" );
 
-    if((Configuration.hsf = SaveFile->value("Sensitivity").toInt()) == 0)
+    if((cfg->hsf = SaveFile.value("Sensitivity").toInt()) == 0)
     {
         return false;
     }
 
-    if((Configuration.upperLevel = SaveFile->value("UpperLevel").toInt()) == 0)
+    if((cfg->upperLevel = SaveFile.value("UpperLevel").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.lowerLevel = SaveFile->value("LowerLevel").toInt()) == 0)
+    if((cfg->lowerLevel = SaveFile.value("LowerLevel").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.upperLimit = SaveFile->value("UpperLimit").toInt()) == 0)
+    if((cfg->upperLimit = SaveFile.value("UpperLimit").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.lowerLimit = SaveFile->value("LowerLimit").toInt()) == 0)
+    if((cfg->lowerLimit = SaveFile.value("LowerLimit").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.upperAlarm = SaveFile->value("UpperAlarm").toInt()) == 0)
+    if((cfg->upperAlarm = SaveFile.value("UpperAlarm").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.lowerAlarm = SaveFile->value("LowerAlarm").toInt()) == 0)
+    if((cfg->lowerAlarm = SaveFile.value("LowerAlarm").toInt()) == 0)
     {
         return false;
     }
 
-    if((Configuration.absMaxBSL = SaveFile->value("AbsoluteMax").toInt()) == 0)
+    if((cfg->absMaxBSL = SaveFile.value("AbsoluteMax").toInt()) == 0)
     {
         return false;
     }
 
-    if((Configuration.resWarn = SaveFile->value("ReservoirWarn").toInt()) == 0)
+    if((cfg->resWarn = SaveFile.value("ReservoirWarn").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.resCrit = SaveFile->value("ReservoirCrit").toInt()) == 0)
+    if((cfg->resCrit = SaveFile.value("ReservoirCrit").toInt()) == 0)
     {
         return false;
     }
 
-    if((Configuration.battWarn = SaveFile->value("BatterieWarn").toInt()) == 0)
+    if((cfg->battWarn = SaveFile.value("BatterieWarn").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.battCrit = SaveFile->value("BatterieCrit").toInt()) == 0)
+    if((cfg->battCrit = SaveFile.value("BatterieCrit").toInt()) == 0)
     {
         return false;
     }
 
-    if((Configuration.maxOpTime = SaveFile->value("MaxOpTime").toInt()) == 0)
+    if((cfg->maxOpTime = SaveFile.value("MaxOpTime").toInt()) == 0)
     {
         return false;
     }
 
-    if((Configuration.contrInt = SaveFile->value("ContrInt").toInt()) == 0)
+    if((cfg->contrInt = SaveFile.value("ContrInt").toInt()) == 0)
     {
         return false;
     }
-    if((Configuration.schedInt = SaveFile->value("SchedInt").toInt()) == 0)
+    if((cfg->schedInt = SaveFile.value("SchedInt").toInt()) == 0)
     {
         return false;
     }
-    SaveFile->endGroup();
-    SaveFile->sync();
 
-    delete SaveFile;
+    // Optional, sub-second scheduler cycles
+    cfg->schedIntMs = SaveFile.value("SchedIntMs", cfg->schedInt * 1000).toInt();
+    if(cfg->schedIntMs <= 0)
+    {
+        return false;
+    }
 
-    return true;
-}
+    // Optional, fixed scheduler interval if not given
+    cfg->adaptive = SaveFile.value("AdaptiveSched", 0).toInt();
+    cfg->schedMinMs = SaveFile.value("SchedMinMs", cfg->schedIntMs / ADAPTIVE_MIN_DIVISOR).toInt();
+    cfg->schedMaxMs = SaveFile.value("SchedMaxMs", cfg->schedIntMs * ADAPTIVE_MAX_FACTOR).toInt();
+    cfg->adaptRate = SaveFile.value("AdaptRate", ADAPTIVE_RATE).toInt();
+    if(cfg->schedMinMs <= 0 || cfg->schedMinMs > cfg->schedIntMs ||
+       cfg->schedMaxMs < cfg->schedIntMs || cfg->adaptRate <= 0)
+    {
+        return false;
+    }
 
+    // Optional, the timer loop is used if not given
+    cfg->tickless = SaveFile.value("Tickless", 1).toInt();
 
+    // Optional, no real-time settings if not given
+    cfg->cpuAffinity = SaveFile.value("CpuAffinity", -1).toInt();
+    cfg->rtPriority = SaveFile.value("RtPriority", 0).toInt();
+    cfg->lockMemory = SaveFile.value("LockMemory", 0).toInt();
+    if(cfg->cpuAffinity < -1 || cfg->rtPriority < 0 || cfg->rtPriority > REALTIME_PRIORITY_MAX)
+    {
+        return false;
+    }
+
+    // Optional, the file exchange is used if not given
+    cfg->transport = SaveFile.value("Transport", TRANSPORT_FILE).toInt();
+    if(cfg->transport < TRANSPORT_FILE || cfg->transport > TRANSPORT_INPROCESS)
+    {
+        return false;
+    }
 
+    // Optional, no recording if not given
+    cfg->record = SaveFile.value("Record", 0).toInt();
+    SaveFile.endGroup();
 
+    return true;
+}
+
+/* Creates the configured pump <-> body transport
+ */
+bool ControlSystem::createTransport(int transport, SensorTransport **sensor,
+                                    InjectionTransport **injection, Body **body)
+{
+    FrameTransport *frames = NULL;
+    *body = NULL;
+
+    switch(transport)
+    {
+        case TRANSPORT_FILE:    frames = new FileTransport();
+                                break;
+        case TRANSPORT_SHM:     frames = new SharedMemoryTransport();
+                                break;
+        case TRANSPORT_SOCKET:  frames = new SocketTransport();
+                                break;
+        case TRANSPORT_INPROCESS:
+        {
+            *body = new Body(INPROCESS_BODY_BSL, INPROCESS_INSULIN_CONSTANT,
+                             INPROCESS_GLUCAGON_CONSTANT);
+            InProcessTransport *direct = new InProcessTransport(*body, INPROCESS_BODY_FACTOR, false);
+            *sensor = direct;
+            *injection = direct;
+            return true;
+        }
+        default:                return false;
+    }
+
+    *sensor = frames;
+    *injection = frames;
+    return true;
+}
@@ -19,15 +19,31 @@
 
 #include <QFileInfo>
 #include <QMessageBox>
+#include <atomic>
+#include <vector>
+#include "AlarmEngine.h"
 #include "Config.h"
 #include "Pump.h"
 #include "Scheduler.h"
 #include "Tracer.h"
+#include "Transport.h"
 #include "UserInterface.h"
 
+class Body;
+
 
 #define CONFIGFILE_NAME "InsulinPump.conf"
 
+#define CONTROL_BACKSTOP_FACTOR 12  // state checks poll every ContrInt * 12, events run them at once
+
+#define BATTERY_BAND_OK     0       // battery above BatterieWarn
+#define BATTERY_BAND_WARN   1       // battery at or below BatterieWarn
+#define BATTERY_BAND_CRIT   2       // battery at or below BatterieCrit
+
+#define ALARM_HYSTERESIS_BATTERY    2   // battery alarms lowered 2 % past their level
+#define ALARM_HYSTERESIS_RESERVOIR  2   // reservoir alarms lowered 2 units past their level
+#define ALARM_HYSTERESIS_BSL        10  // blood sugar alarms lowered 10 mg/dL past their level
+
 
 
 class ControlSystem : public QObject
@@ -40,11 +56,23 @@ class ControlSystem : public QObject
          * @brief:  Control Systems Constructor
          *
          *  The constructor instantiates all necessary objects
-         *  and connects some signals to slots for the user interface
+         *  and connects some signals to slots for the user interface.
+         *  With a simulated clock the body always runs in process.
+         *
+         * @param:  A pointer to the user interface for callbacks, NULL for none
+         * @param:  The clock of the whole stack, NULL for the real clock
+         */
+        ControlSystem(UserInterface* ui, Clock *clock = NULL);
+
+        /**
+         * @name:   ~Control System
+         * @brief:  Control System Destructor
          *
-         * @param:  A pointer to the user interface for callbacks
+         *  Stops the checks & the pump cycle and saves the operation
+         *  time, then deletes the scheduler before the pump, the pump
+         *  before its transports & recorder and the tracer last
          */
-        ControlSystem(UserInterface* ui);
+        ~ControlSystem();
 
         /**
          * @name:   Check Operation Hours
@@ -91,6 +119,17 @@ class ControlSystem : public QObject
          */
         virtual bool checkTracer();
 
+        /**
+         * @name:   Report Diagnostics / Statistics
+         * @brief:  Reports the latency histograms of the scheduler
+         *
+         *  The histograms of all jobs are sent to the diagnostics view of
+         *  the user interface, the ones of the pump cycle to the log together
+         *  with the wake-ups & the CPU use of the scheduler
+         */
+        virtual void reportDiagnostics();
+        virtual void reportStatistics();
+
         /**
          * @name:   Check Battery Status
          * @brief:  Checks the batteries charging state in percent
@@ -111,6 +150,14 @@ class ControlSystem : public QObject
          */
         virtual Scheduler *getScheduler();
 
+        /**
+         * @name:   Get Alarms
+         * @brief:  Get the alarms of the health checks
+         *
+         * @return: A pointer to the alarm engine
+         */
+        virtual AlarmEngine *getAlarms();
+
         /**
          * @name:   Get Bettery Minimum Load
          * @brief:  Get the minimum battery load level in percent
@@ -131,6 +178,9 @@ class ControlSystem : public QObject
          * @name:   Get/Set Should Run
          * @brief:  Get/Set the should run flag for the thread
          *
+         *  The health checks run as jobs of the scheduler,
+         *  they do nothing while the flag is cleared
+         *
          * @param:  'true' if the thread should run
          * @return: When the thread should run, 'true' is returned
          */
@@ -145,6 +195,35 @@ class ControlSystem : public QObject
          */
         virtual int getIntervalSec() const;
 
+        /**
+         * @name:   Load Configuration
+         * @brief:  Reads the static configuration from a file
+         *
+         *  Reads the "InsulinPump-Static" section of the configuration
+         *  file, also usable without a control system (benchmarks)
+         *
+         * @param:  The filename of the configuration file
+         * @param:  The configuration to fill
+         * @return: When all values could be read, 'true' is returned
+         */
+        static bool loadConfiguration(QString filename, config *cfg);
+
+        /**
+         * @name:   Create Transport
+         * @brief:  Creates the configured pump <-> body transport
+         *
+         *  For TRANSPORT_INPROCESS a body model is created as well.
+         *  Readings & injections use one object, deleted once.
+         *
+         * @param:  One of TRANSPORT_*
+         * @param:  Receives the transport the readings come from
+         * @param:  Receives the transport the injections go to
+         * @param:  Receives the body model, NULL if not in process
+         * @return: When the transport is known, 'true' is returned
+         */
+        static bool createTransport(int transport, SensorTransport **sensor,
+                                    InjectionTransport **injection, Body **body);
+
     private:
         /**
          * @name:   The Pump
@@ -165,12 +244,25 @@ class ControlSystem : public QObject
         Tracer *TheTracer;
 
         /**
-         * @name:   Save File
-         * @brief:  QSettings object for the configuration file
-         *
-         *  File for loading some specific configuration values
+         * @name:   The Clock
+         * @brief:  Time source of tracer, scheduler & user interface
          */
-        QSettings *SaveFile;
+        Clock *TheClock;
+
+        /**
+         * @name:   Sensor/Injection Transport
+         * @brief:  The connection between pump and body
+         */
+        SensorTransport *TheSensorTransport;
+        InjectionTransport *TheInjectionTransport;
+
+        /**
+         * @name:   The Body / The Recorder
+         * @brief:  Body model of the in-process transport / trace of
+         *          the pump cycles, NULL if not used
+         */
+        Body *TheBody;
+        TraceRecorder *TheRecorder;
 
         /**
          * @name:   Operation Time
@@ -178,6 +270,18 @@ class ControlSystem : public QObject
          */
         quint64 OperationTime;
 
+        /**
+         * @name:   Missed Deadlines
+         * @brief:  Scheduler deadlines missed until the last check
+         */
+        quint64 MissedDeadlines;
+
+        /**
+         * @name:   Real Time Problems
+         * @brief:  Real-time settings of the scheduler not applied at the last check
+         */
+        QString RealTimeProblems;
+
         /**
          * @name:   Schould Run
          * @brief:  Flag for the thread method
@@ -186,7 +290,53 @@ class ControlSystem : public QObject
          *  If 'SchoulRun' is true, the control system thread loop will run
          *  If 'ShouldRun' is flase, the thread stops the periodic checking
          */
-        bool SchouldRun;
+        std::atomic<bool> SchouldRun;
+
+        /**
+         * @name:   Check Jobs
+         * @brief:  Numbers of the state check jobs of the scheduler,
+         *          polling every ContrInt * CONTROL_BACKSTOP_FACTOR
+         */
+        std::vector<int> CheckJobs;
+
+        /**
+         * @name:   Battery / Pump / Scheduler / Tracer / Operation Check
+         * @brief:  Numbers of the check jobs run by the events, the
+         *          scheduler check polls every ContrInt for stalls, the
+         *          operation check every ContrInt as nothing reports it
+         */
+        int BatteryCheck;
+        int PumpCheck;
+        int SchedulerCheck;
+        int TracerCheck;
+        int OperationCheck;
+
+        /**
+         * @name:   Battery Band
+         * @brief:  BATTERY_BAND_* of the last battery level event
+         */
+        std::atomic<int> BatteryBand;
+
+        /**
+         * @name:   The Alarms
+         * @brief:  Alarm engine of the checks & the numbers of its alarms
+         */
+        AlarmEngine *TheAlarms;
+        int BatteryAlarm;
+        int InsulinAlarm;
+        int GlucagonAlarm;
+        int OperationAlarm;
+        int HighBslAlarm;
+        int LowBslAlarm;
+
+        /**
+         * @name:   Near Max Operation Hours
+         * @brief:  Warning level of the operation time, 90 % of the maximum
+         *
+         * @param:  The maximum operation time in hours
+         * @return: The warning level in hours
+         */
+        static int nearMaxOperationHours(int hours);
 
         /**
          * @name:   Configuration values
@@ -202,6 +352,40 @@ class ControlSystem : public QObject
          */
         virtual bool readConfiguration(QString filename);
 
+        /**
+         * @name:   Connect User Interface
+         * @brief:  Connects the signals & slots of the user interface
+         *
+         * @param:  A pointer to the user interface
+         */
+        virtual void connectUserInterface(UserInterface* ui);
+
+    private slots:
+        /**
+         * @name:   Battery Level Changed / Pump Status Changed /
+         *          Tracer Status Changed / Deadline Missed
+         * @brief:  Events of pump, tracer & scheduler
+         *
+         *  Directly connected, so they run on the thread of the event:
+         *  they only trigger the matching check job, the battery check
+         *  only when the level crossed BatterieWarn or BatterieCrit
+         *
+         * @param:  The new battery level / pump status / tracer status
+         */
+        void batteryLevelChanged(int level);
+        void pumpStatusChanged(int status);
+        void tracerStatusChanged(int status);
+        void deadlineMissed();
+
+        /**
+         * @name:   Blood Sugar Level Changed
+         * @brief:  Feeds the reading of every pump cycle to the blood
+         *          sugar alarms, directly on the thread of the cycle
+         *
+         * @param:  The blood sugar level in mg/dL
+         */
+        void bloodSugarLevelChanged(int level);
+
     public slots:
         /**
          * @name:   Set Bettery Minimum Load
@@ -269,6 +453,17 @@ class ControlSystem : public QObject
          * @param:  The new control thread interval in seconds
          */
         void updateControlThreadInterval(int seconds);
+
+        /**
+         * @name:   Update Diagnostics
+         * @brief:  Sets the scheduler diagnostics in the UI
+         *
+         *  Signal that gets emitted periodically with the
+         *  latency histograms of the scheduler jobs
+         *
+         * @param:  One line per job
+         */
+        void updateDiagnostics(QStringList lines);
 };
 
 #endif
@@ -0,0 +1,55 @@
+/**
+ * @file:   FileTransport.cpp
+ * @class:  FileTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump side of the pipe_to_pump / pipe_to_body file exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "FileTransport.h"
+#include <fstream>
+#include <stdio.h>
+
+using namespace std;
+
+
+
+/* Reads and removes pipe_to_pump, a frame the body is
+ * still writing is left for the next cycle
+ */
+int FileTransport::receiveFrame(wireframe *buffer)
+{
+    ifstream file(FILE_TO_PUMP, ios_base::in | ios_base::binary);
+
+    if(!file.good())
+    {
+        return 0;
+    }
+
+    file.read(reinterpret_cast<char*>(buffer), sizeof(wireframe));
+    int size = file.gcount();
+    file.close();
+
+    if(size < (int)sizeof(wireframe))
+    {
+        return 0;
+    }
+    remove(FILE_TO_PUMP);
+
+    return size;
+}
+
+/* Writes the frame to pipe_to_body
+ */
+void FileTransport::sendFrame(const wireframe *frame)
+{
+    ofstream file(FILE_TO_BODY, ios_base::out | ios_base::binary);
+    file.write(reinterpret_cast<const char*>(frame), sizeof(wireframe));
+    file.close();
+}
@@ -0,0 +1,47 @@
+/**
+ * @file:   FileTransport.h
+ * @class:  FileTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump side of the pipe_to_pump / pipe_to_body file exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef filetransport_
+#define filetransport_
+
+#include "Transport.h"
+
+
+#define FILE_TO_PUMP    "pipe_to_pump"
+#define FILE_TO_BODY    "pipe_to_body"
+
+
+
+class FileTransport : public FrameTransport
+{
+    protected:
+        /**
+         * @name:   Receive Frame
+         * @brief:  Reads and removes pipe_to_pump
+         *
+         * @param:  The buffer for the frame
+         * @return: The number of bytes read, 0 if there was no file
+         */
+        virtual int receiveFrame(wireframe *buffer);
+
+        /**
+         * @name:   Send Frame
+         * @brief:  Writes the frame to pipe_to_body
+         *
+         * @param:  The frame
+         */
+        virtual void sendFrame(const wireframe *frame);
+};
+
+#endif
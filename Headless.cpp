@@ -0,0 +1,674 @@
+/**
+ * @file:   Headless.cpp
+ * @class:  Headless
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Runs of the pump without user interface
+ *          Benchmarks, batch runs & comparisons started from main()
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "Headless.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "AdaptiveInterval.h"
+#include "ControlSystem.h"
+#include "ParameterSweep.h"
+#include "Scheduler.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+
+
+/**
+ * Tracer for batch runs, shared by all pumps of all workers
+ *
+ * @brief Only counts the messages, no logfile & no UI
+ */
+class BatchTracer : public Tracer
+{
+    public:
+        BatchTracer() : Tracer(""), Status(0), Warnings(0), Criticals(0) {}
+
+        virtual bool writeStatusLog(QString) { Status++; return true; }
+        virtual bool writeWarningLog(QString) { Warnings++; return true; }
+        virtual bool writeCriticalLog(QString) { Criticals++; return true; }
+
+        atomic<long> Status;
+        atomic<long> Warnings;
+        atomic<long> Criticals;
+};
+
+/**
+ * One simulated patient of a batch run
+ */
+struct patient{
+    Body body;
+    InProcessTransport transport;
+    Pump pump;
+    long failed;
+
+    patient(Tracer *tracer, config cfg, float factor, bool rising) :
+        body(INPROCESS_BODY_BSL, INPROCESS_INSULIN_CONSTANT, INPROCESS_GLUCAGON_CONSTANT),
+        transport(&body, factor, rising),
+        pump(tracer, cfg, &transport, &transport),
+        failed(0) { pump.initPump(); }
+};
+
+/**
+ * In-process body on the clock of the scheduler
+ *
+ * @brief The body does one step per base interval of the scheduler, however
+ *        often the pump samples, and counts the steps within the range.
+ *        Readings between two steps are interpolated.
+ */
+class ClockedTransport : public SensorTransport, public InjectionTransport
+{
+    public:
+        ClockedTransport(Body *body, float factor, bool rising, int stepMs) :
+            Steps(0), InRange(0), Hypo(0), Hyper(0), TheBody(body), Factor(factor),
+            Rising(rising), StepMs(stepMs), Clock(0), InsulinUnits(0), GlucagonUnits(0),
+            Below(false), Above(false) {}
+
+        // between two steps the level moves linearly towards the next one
+        virtual int readBloodSugarLevel()
+        {
+            Body ahead = *TheBody;
+            int insulin = InsulinUnits, glucagon = GlucagonUnits;
+            ahead.simulateStep(Factor, Rising, insulin, glucagon);
+
+            float level = TheBody->getBloodSugarLevel();
+            return (int)(level + (ahead.getBloodSugarLevel() - level) * Clock / StepMs);
+        }
+
+        // a dose replaces the pending units, a cycle without one does not
+        // take back what was delivered, however often the pump samples
+        virtual void injectHormones(int insulinUnits, int glucagonUnits)
+        {
+            if(insulinUnits > 0 || glucagonUnits > 0)
+            {
+                InsulinUnits = insulinUnits;
+                GlucagonUnits = glucagonUnits;
+            }
+        }
+
+        void advance(long milliseconds)
+        {
+            for(Clock += milliseconds; Clock >= StepMs; Clock -= StepMs)
+            {
+                TheBody->simulateStep(Factor, Rising, InsulinUnits, GlucagonUnits);
+
+                int level = (int)TheBody->getBloodSugarLevel();
+                bool below = level < SWEEP_RANGE_LOW;
+                bool above = level > SWEEP_RANGE_HIGH;
+                Steps++;
+                InRange += !below && !above;
+                Hypo += below && !Below;
+                Hyper += above && !Above;
+                Below = below;
+                Above = above;
+            }
+        }
+
+        long Steps;
+        long InRange;
+        long Hypo;
+        long Hyper;
+
+    private:
+        Body *TheBody;
+        float Factor;
+        bool Rising;
+        long StepMs;
+        long Clock;
+        int InsulinUnits;
+        int GlucagonUnits;
+        bool Below;
+        bool Above;
+};
+
+
+/* The harness starts without a pump
+ */
+Headless::Headless() :
+    TheTracer(NULL),
+    TheBody(NULL),
+    Transport(NULL),
+    ThePump(NULL)
+{
+}
+
+/* The destructor deletes the stack in reverse order of its creation
+ */
+Headless::~Headless()
+{
+    delete ThePump;
+    delete Transport;
+    delete TheBody;
+    delete TheTracer;
+}
+
+/* Reads the configuration file, the message is printed here
+ */
+bool Headless::loadConfiguration()
+{
+    if(!ControlSystem::loadConfiguration(CONFIGFILE_NAME, &Configuration))
+    {
+        cerr << "Problem parsing the configuration file!" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+/* Tracer with logfile, in-process body & the initialized pump
+ */
+Pump &Headless::createPump()
+{
+    TheTracer = new Tracer();
+    TheBody = new Body(INPROCESS_BODY_BSL, INPROCESS_INSULIN_CONSTANT, INPROCESS_GLUCAGON_CONSTANT);
+    Transport = new InProcessTransport(TheBody, INPROCESS_BODY_FACTOR, false);
+    ThePump = new Pump(TheTracer, Configuration, Transport, Transport);
+    ThePump->initPump();
+
+    return *ThePump;
+}
+
+
+/* Headless throughput benchmark, battery & reservoirs kept filled
+ */
+int Headless::benchmark(long cycles)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+
+    Pump &ThePump = harness.createPump();
+
+    TraceRecorder *recorder = NULL;
+    if(Configuration.record)
+    {
+        recorder = new TraceRecorder(TRACE_FILE_NAME);
+        ThePump.setRecorder(recorder);
+    }
+
+    long failed = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(long cycle = 0; cycle < cycles; cycle++)
+    {
+        ThePump.changeBatteryPowerLevel(100);
+        ThePump.refillInsulinReservoir();
+        ThePump.refillGlucagonReservoir();
+
+        if(!ThePump.runPump())
+        {
+            failed++;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Pump cycles:  " << cycles << " (" << failed << " failed)" << endl;
+    cout << "Duration:     " << seconds << " s" << endl;
+    cout << "Throughput:   " << (seconds > 0 ? cycles / seconds : 0) << " cycles/s" << endl;
+    cout << "Final BSL:    " << harness.TheBody->getBloodSugarLevel() << " mg/dL" << endl;
+
+    delete recorder;
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Batch co-simulation, one task of the pool per patient
+ */
+int Headless::batch(long cycles, int patients, int threads)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+
+    BatchTracer TheTracer;
+    vector< unique_ptr<patient> > Patients;
+    for(int i = 0; i < patients; i++)
+    {
+        Patients.push_back(unique_ptr<patient>(
+            new patient(&TheTracer, Configuration, 1.00 + (i % 5) * 0.01, i % 2)));
+    }
+
+    WorkStealingPool Pool(threads);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int i = 0; i < patients; i++)
+    {
+        patient *p = Patients[i].get();
+        Pool.submit([p, cycles]
+        {
+            for(long cycle = 0; cycle < cycles; cycle++)
+            {
+                p->pump.changeBatteryPowerLevel(100);
+                p->pump.refillInsulinReservoir();
+                p->pump.refillGlucagonReservoir();
+
+                if(!p->pump.runPump())
+                {
+                    p->failed++;
+                }
+            }
+        });
+    }
+    Pool.wait();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long failed = 0;
+    for(int i = 0; i < patients; i++)
+    {
+        failed += Patients[i]->failed;
+    }
+    double total = (double)cycles * patients;
+
+    cout << "Patients:     " << patients << " on " << Pool.getThreadCount() << " threads ("
+         << Pool.getStolenTasks() << " stolen)" << endl;
+    cout << "Pump cycles:  " << total << " (" << failed << " failed)" << endl;
+    cout << "Messages:     " << TheTracer.Warnings << " warnings, "
+         << TheTracer.Criticals << " critical" << endl;
+    cout << "Duration:     " << seconds << " s" << endl;
+    cout << "Throughput:   " << (seconds > 0 ? total / seconds : 0) << " cycles/s" << endl;
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Replay of a recorded trace, compared with the recorded injections
+ */
+int Headless::replay(const char *filename)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+
+    TraceReplay trace(filename);
+    if(!trace.isValid())
+    {
+        cerr << "Could not load the trace " << filename << "!" << endl;
+        return EXIT_FAILURE;
+    }
+
+    BatchTracer TheTracer;
+    Pump ThePump(&TheTracer, Configuration, &trace, &trace);
+    ThePump.initPump();
+
+    tracestate state;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while(trace.nextCycle(&state))
+    {
+        if(state.battery >= 0)
+        {
+            ThePump.changeBatteryPowerLevel(state.battery);
+        }
+        if(state.insulinReservoir >= 0)
+        {
+            ThePump.setInsulinAmount(state.insulinReservoir);
+            ThePump.setGlucagonAmount(state.glucagonReservoir);
+        }
+        ThePump.runPump();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Replayed:     " << trace.getCycles() << " cycles of " << filename << endl;
+    cout << "Mismatches:   " << trace.getMismatches() << endl;
+    cout << "Duration:     " << seconds << " s" << endl;
+    cout << "Throughput:   " << (seconds > 0 ? trace.getCycles() / seconds : 0) << " cycles/s" << endl;
+
+    return trace.getMismatches() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+/* Parallel sweep over the therapy parameters, CSV to stdout
+ */
+int Headless::sweep(const char *filename, int threads)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+
+    ParameterSweep Sweep(Configuration);
+    if(!Sweep.load(filename))
+    {
+        cerr << "Problem parsing the sweep file " << filename << "!" << endl;
+        return EXIT_FAILURE;
+    }
+
+    BatchTracer TheTracer;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    Sweep.run(&TheTracer, threads);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    Sweep.print(cout);
+    cerr << "Swept " << Sweep.getPoints() << " parameter sets in " << seconds << " s ("
+         << (seconds > 0 ? Sweep.getPoints() / seconds : 0) << " sets/s)" << endl;
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Fixed against adaptive sampling interval, on simulated time
+ */
+int Headless::sampling(long steps)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+
+    BatchTracer TheTracer;
+    long total = steps * Configuration.schedIntMs;
+    int charge = MAX_BATTERY_CHARGE - Configuration.battCrit;
+
+    cout << "Interval " << Configuration.schedIntMs << " ms, adaptive " << Configuration.schedMinMs
+         << "-" << Configuration.schedMaxMs << " ms, " << steps * SAMPLING_HOURS << " h per scenario" << endl;
+    cout << "scenario,mode,cycles,batteryHours,timeInRange,hypoEvents,hyperEvents" << endl;
+
+    for(int scenario = 0; scenario < SWEEP_SCENARIOS; scenario++)
+    {
+        float factor;
+        bool rising;
+        ParameterSweep::getScenario(scenario, &factor, &rising);
+
+        for(int adaptive = 0; adaptive <= 1; adaptive++)
+        {
+            Body body(INPROCESS_BODY_BSL, INPROCESS_INSULIN_CONSTANT, INPROCESS_GLUCAGON_CONSTANT);
+            ClockedTransport transport(&body, factor, rising, Configuration.schedIntMs);
+            Pump ThePump(&TheTracer, Configuration, &transport, &transport);
+            ThePump.initPump();
+            ThePump.changeBatteryPowerLevel(MAX_BATTERY_CHARGE);
+            AdaptiveInterval Policy(Configuration);
+
+            long cycles = 0;
+            long consumed = 0;
+            int interval = Configuration.schedIntMs;
+            for(long now = 0; now < total; )
+            {
+                if(ThePump.getBatteryPowerLevel() <= Configuration.battCrit)
+                {
+                    consumed += MAX_BATTERY_CHARGE - ThePump.getBatteryPowerLevel();
+                    ThePump.changeBatteryPowerLevel(MAX_BATTERY_CHARGE);
+                }
+                ThePump.refillInsulinReservoir();
+                ThePump.refillGlucagonReservoir();
+                ThePump.runPump();
+                cycles++;
+
+                if(adaptive)
+                {
+                    interval = Policy.next(ThePump.getCurrentBSLevel(), interval,
+                                           ThePump.getBatteryPowerLevel());
+                }
+                long next = now + interval < total ? now + interval : total;
+                transport.advance(next - now);
+                now = next;
+            }
+            // the charge actually drained, injecting cycles drain more
+            consumed += MAX_BATTERY_CHARGE - ThePump.getBatteryPowerLevel();
+
+            cout << scenario + 1 << "," << (adaptive ? "adaptive" : "fixed") << "," << cycles << ","
+                 << (consumed > 0 ? steps * SAMPLING_HOURS * charge / consumed : 0) << ","
+                 << (transport.Steps > 0 ? 100.0 * transport.InRange / transport.Steps : 0) << ","
+                 << transport.Hypo << "," << transport.Hyper << endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Wakeup latency of a new interval, an event & a shutdown
+ */
+int Headless::latency(int runs)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+    Configuration.schedIntMs = LATENCY_IDLE_MS;
+
+    Pump &ThePump = harness.createPump();
+
+    double interval_sum = 0, interval_max = 0, shutdown_sum = 0, shutdown_max = 0;
+    double event_sum = 0, event_max = 0;
+    for(int run = 0; run < runs; run++)
+    {
+        Scheduler TheScheduler(&ThePump, Configuration);
+        atomic<int> checks(0);
+        int check = TheScheduler.addJob("check", [&checks]() { checks++; }, LATENCY_IDLE_MS,
+                                        SCHEDULER_PRIORITY_SERVICE, 0);
+        TheScheduler.start();
+
+        // the first cycle & check are done, both wait for the next release
+        while(TheScheduler.getCycles() < 1 || checks < 1)
+        {
+            this_thread::yield();
+        }
+        this_thread::sleep_for(chrono::milliseconds(2));
+
+        // an event, as the health monitoring gets it
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        TheScheduler.triggerJob(check);
+        while(checks < 2)
+        {
+            this_thread::yield();
+        }
+        double event_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        this_thread::sleep_for(chrono::milliseconds(2));
+
+        // the new interval has already passed since the start of the cycle
+        start = chrono::steady_clock::now();
+        TheScheduler.setIntervalMs(1);
+        while(TheScheduler.getCycles() < 2)
+        {
+            this_thread::yield();
+        }
+        double interval_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+        TheScheduler.setIntervalMs(LATENCY_IDLE_MS);
+        this_thread::sleep_for(chrono::milliseconds(2));
+
+        start = chrono::steady_clock::now();
+        TheScheduler.setSchouldRun(false);
+        double shutdown_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+        interval_sum += interval_us;
+        interval_max = interval_us > interval_max ? interval_us : interval_max;
+        shutdown_sum += shutdown_us;
+        shutdown_max = shutdown_us > shutdown_max ? shutdown_us : shutdown_max;
+        event_sum += event_us;
+        event_max = event_us > event_max ? event_us : event_max;
+    }
+
+    cout << "Runs:              " << runs << endl;
+    cout << "New interval [us]: avg " << interval_sum / runs << ", max " << interval_max
+         << " (incl. one pump cycle)" << endl;
+    cout << "Event [us]:        avg " << event_sum / runs << ", max " << event_max << endl;
+    cout << "Shutdown [us]:     avg " << shutdown_sum / runs << ", max " << shutdown_max << endl;
+
+    if(interval_max >= LATENCY_LIMIT_US || event_max >= LATENCY_LIMIT_US ||
+       shutdown_max >= LATENCY_LIMIT_US)
+    {
+        cerr << "Wakeup latency reached " << LATENCY_LIMIT_US << " us!" << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Wake-ups & CPU of the scheduler, tickless and not
+ */
+int Headless::idle(int seconds)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+
+    Pump &ThePump = harness.createPump();
+
+    cout << "mode,seconds,cycles,wakeupsPerMin,cpuPercent" << endl;
+    for(int tickless = 1; tickless >= 0; tickless--)
+    {
+        Configuration.tickless = tickless;
+        Scheduler TheScheduler(&ThePump, Configuration);
+        // the scheduler & operation checks poll, the others are a backstop for events
+        for(int i = 0; i < IDLE_CHECK_JOBS; i++)
+        {
+            TheScheduler.addJob("check", []() {},
+                                Configuration.contrInt * 1000 * (i < 2 ? 1 : CONTROL_BACKSTOP_FACTOR),
+                                SCHEDULER_PRIORITY_SERVICE, 0);
+        }
+        TheScheduler.addJob("diagnostics", []() {}, SCHEDULER_DIAGNOSTICS_MS,
+                            SCHEDULER_PRIORITY_SERVICE, 0);
+        TheScheduler.addJob("statistics", []() {}, SCHEDULER_STATISTICS_MS,
+                            SCHEDULER_PRIORITY_SERVICE, 0);
+
+        TheScheduler.start();
+        TheScheduler.getIdleStatistics(NULL, NULL);
+        this_thread::sleep_for(chrono::seconds(seconds));
+        double wakeups, cpu;
+        TheScheduler.getIdleStatistics(&wakeups, &cpu);
+        TheScheduler.setSchouldRun(false);
+
+        cout << (TheScheduler.isTickless() ? "tickless" : "ticking") << "," << seconds << ","
+             << TheScheduler.getCycles() << "," << wakeups << "," << cpu << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Pump cycle jitter under load, per real-time setting
+ */
+int Headless::realtime(int seconds)
+{
+    Headless harness;
+    if(!harness.loadConfiguration())
+    {
+        return EXIT_FAILURE;
+    }
+    config &Configuration = harness.Configuration;
+    int cpu = Configuration.cpuAffinity >= 0 ? Configuration.cpuAffinity : 0;
+    int priority = Configuration.rtPriority > 0 ? Configuration.rtPriority : REALTIME_PRIORITY;
+    Configuration.schedIntMs = REALTIME_CYCLE_MS;
+    Configuration.adaptive = 0;
+
+    Pump &ThePump = harness.createPump();
+
+    // synthetic load at default priority, on every CPU
+    atomic<bool> loaded(true);
+    vector<thread> load;
+    int cpus = thread::hardware_concurrency() > 0 ? thread::hardware_concurrency() : 1;
+    for(int i = 0; i < cpus; i++)
+    {
+        load.push_back(thread([&loaded]()
+                              {
+                                  while(loaded)
+                                  {
+                                      vector<char> buffer(1 << 20);
+                                      for(size_t j = 0; j < buffer.size(); j += 4096)
+                                      {
+                                          buffer[j] = (char)j;
+                                      }
+                                  }
+                              }));
+    }
+
+    const char *settings[] = { "none", "affinity", "priority", "memory", "all" };
+    cout << "setting,problems,cycles,missed,lateP50,lateP99,lateP999,lateMax" << endl;
+    for(int i = 0; i < 5; i++)
+    {
+        Configuration.cpuAffinity = (i == 1 || i == 4) ? cpu : -1;
+        Configuration.rtPriority = (i == 2 || i == 4) ? priority : 0;
+        Configuration.lockMemory = (i == 3 || i == 4) ? 1 : 0;
+
+        Scheduler TheScheduler(&ThePump, Configuration);
+        TheScheduler.start();
+        this_thread::sleep_for(chrono::seconds(seconds));
+        TheScheduler.setSchouldRun(false);
+
+        histogramsummary lateness, execution;
+        TheScheduler.getCycleStatistics(&lateness, &execution);
+        QString problems = TheScheduler.getRealTimeProblems();
+        cout << settings[i] << ",\"" << (problems.isEmpty() ? "" : problems.toStdString()) << "\","
+             << TheScheduler.getCycles() << "," << TheScheduler.getMissedDeadlines() << ","
+             << lateness.p50 << "," << lateness.p99 << "," << lateness.p999 << ","
+             << lateness.max << endl;
+    }
+
+    loaded = false;
+    for(size_t i = 0; i < load.size(); i++)
+    {
+        load[i].join();
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+/* Full control stack in simulated time
+ */
+int Headless::timelapse(double hours)
+{
+    SimulatedClock TheClock(QDateTime::currentDateTime());
+    ControlSystem* TheControlSystem = new ControlSystem(NULL, &TheClock);
+    Scheduler* TheScheduler = TheControlSystem->getScheduler();
+    if(hours <= 0)
+    {
+        hours = TheControlSystem->getMaxOperationHours();
+    }
+
+    quint64 started = TheScheduler->getOperationTime();
+    TheScheduler->start();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    TheScheduler->simulate((quint64)(hours * 3600000));
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    quint64 operation = TheScheduler->getOperationTime();
+
+    TheControlSystem->setSchouldRun(false);
+    TheScheduler->setSchouldRun(false);
+
+    cout << "Simulated:    " << hours << " h in " << seconds << " s ("
+         << (seconds > 0 ? hours * 3600 / seconds : 0) << "x real time)" << endl;
+    cout << "Pump cycles:  " << TheScheduler->getCycles() << endl;
+    cout << "Operation:    " << started / 3600000 << " h -> " << operation / 3600000 << " h (max "
+         << TheControlSystem->getMaxOperationHours() << " h)" << endl;
+    cout << "Alarms:       " << TheControlSystem->getAlarms()->getNotified() << " notified, "
+         << TheControlSystem->getAlarms()->getSuppressed() << " repeats suppressed" << endl;
+    cout << "Log:          " << SIM_LOGFILE_NAME << endl;
+
+    delete TheControlSystem;
+
+    return EXIT_SUCCESS;
+}
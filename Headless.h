@@ -0,0 +1,217 @@
+/**
+ * @file:   Headless.h
+ * @class:  Headless
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Runs of the pump without user interface
+ *          Benchmarks, batch runs & comparisons started from main()
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef headless_
+#define headless_
+
+#include "Config.h"
+#include "InProcessTransport.h"
+#include "Pump.h"
+#include "Tracer.h"
+
+
+#define LATENCY_IDLE_MS     60000   // latency check: interval the scheduler waits on
+#define LATENCY_LIMIT_US    1000    // latency check: upper bound for a wakeup
+#define IDLE_SECONDS        60      // idle comparison: wall time per mode
+#define IDLE_CHECK_JOBS     5       // idle comparison: health checks of the control system
+#define REALTIME_SECONDS    10      // real-time comparison: wall time per setting
+#define REALTIME_CYCLE_MS   10      // real-time comparison: pump cycle interval
+#define REALTIME_PRIORITY   50      // real-time comparison: RtPriority if not configured
+#define SAMPLING_STEPS      96      // sampling comparison: body steps per scenario
+#define SAMPLING_HOURS      0.5     // sampling comparison: body time of one step
+
+
+
+class Headless
+{
+    public:
+        /**
+         * @name:   Benchmark
+         * @brief:  Headless throughput benchmark of the pump control loop
+         *
+         *  Runs the pump against the in-process body as fast as possible,
+         *  battery & reservoirs are kept filled, no UI & no scheduler
+         *
+         * @param:  The number of pump cycles to run
+         * @return: EXIT_SUCCESS, EXIT_FAILURE if the configuration is unusable
+         */
+        static int benchmark(long cycles);
+
+        /**
+         * @name:   Batch
+         * @brief:  Headless batch co-simulation of many independent pump & body pairs
+         *
+         *  Every patient runs its pump cycles as one task of a work stealing
+         *  thread pool, the patients differ in body factor & direction
+         *
+         * @param:  The number of pump cycles per patient
+         * @param:  The number of patients
+         * @param:  The number of worker threads, 0 for one per core
+         * @return: EXIT_SUCCESS, EXIT_FAILURE if the configuration is unusable
+         */
+        static int batch(long cycles, int patients, int threads);
+
+        /**
+         * @name:   Replay
+         * @brief:  Replay of a recorded trace without a body
+         *
+         *  Feeds the recorded readings through the pump as fast as possible
+         *  and compares its injections with the recorded ones
+         *
+         * @param:  The filename of the trace
+         * @return: EXIT_SUCCESS if the pump behaved like recorded, else EXIT_FAILURE
+         */
+        static int replay(const char *filename);
+
+        /**
+         * @name:   Sweep
+         * @brief:  Parallel sweep over the therapy parameters
+         *
+         *  Simulates every parameter set of the sweep file with all body
+         *  scenarios, CSV results go to stdout, the summary to stderr
+         *
+         * @param:  The filename of the sweep file
+         * @param:  The number of worker threads, 0 for one per core
+         * @return: EXIT_SUCCESS, EXIT_FAILURE if a file is unusable
+         */
+        static int sweep(const char *filename, int threads);
+
+        /**
+         * @name:   Sampling
+         * @brief:  Fixed against adaptive sampling interval
+         *
+         *  Runs the body scenarios once with the fixed SchedIntMs and once
+         *  with the AdaptiveInterval, on simulated time. The battery is
+         *  recharged at BatterieCrit, its life is the body time per charge
+         *  drained over the scenario.
+         *
+         * @param:  The number of body steps per scenario, one step per SchedIntMs
+         * @return: EXIT_SUCCESS, EXIT_FAILURE if the configuration is unusable
+         */
+        static int sampling(long steps);
+
+        /**
+         * @name:   Latency
+         * @brief:  Wakeup latency of the scheduler
+         *
+         *  Lets the pump job wait on a long interval, then measures how long
+         *  a new interval takes to start the next cycle, how long an event
+         *  takes to start a waiting check job and how long a shutdown takes
+         *  until the executor threads are joined
+         *
+         * @param:  The number of measurements
+         * @return: EXIT_SUCCESS, EXIT_FAILURE if the configuration is unusable or a
+         *          latency reached LATENCY_LIMIT_US
+         */
+        static int latency(int runs);
+
+        /**
+         * @name:   Idle
+         * @brief:  Idle cost of the scheduler, tickless against every thread waking itself
+         *
+         *  Runs the pump cycle with the in-process body and empty stand-ins
+         *  for the health check, diagnostics & statistics jobs of the control
+         *  system at their periods, once with the timer loop and once
+         *  without, and reports the wake-ups per minute and the CPU use
+         *
+         * @param:  The wall time of each mode in seconds
+         * @return: EXIT_SUCCESS, EXIT_FAILURE if the configuration is unusable
+         */
+        static int idle(int seconds);
+
+        /**
+         * @name:   Realtime
+         * @brief:  Pump cycle jitter under load, with each real-time setting
+         *
+         *  Runs the pump cycle with the in-process body every
+         *  REALTIME_CYCLE_MS while one thread per CPU spins and allocates,
+         *  first without real-time settings, then with the CPU affinity,
+         *  the SCHED_FIFO priority, the locked memory and all of them, and
+         *  prints the lateness percentiles of each as CSV. The configured
+         *  CPU & priority are used, else CPU 0 and REALTIME_PRIORITY.
+         *
+         * @param:  The wall time of each setting in seconds
+         * @return: EXIT_SUCCESS, EXIT_FAILURE if the configuration is unusable
+         */
+        static int realtime(int seconds);
+
+        /**
+         * @name:   Timelapse
+         * @brief:  Full control stack in simulated time
+         *
+         *  Runs tracer, pump, scheduler & control system with all jobs on a
+         *  simulated clock, the body in process and without UI. The
+         *  operation time starts at the persisted one but is not saved,
+         *  the log goes to SIM_LOGFILE_NAME.
+         *
+         * @param:  The simulated hours, 0 for the maximum operation time
+         * @return: EXIT_SUCCESS, exits with EXIT_FAILURE if the configuration is unusable
+         */
+        static int timelapse(double hours);
+
+    private:
+        /**
+         * @name:   Headless
+         * @brief:  Headless Constructor
+         *
+         *  The harness of one run, starts without a pump
+         */
+        Headless();
+
+        /**
+         * @name:   ~Headless
+         * @brief:  Headless Destructor
+         *
+         *  Deletes the pump, the body & the tracer
+         */
+        ~Headless();
+
+        /**
+         * @name:   Load Configuration
+         * @brief:  Reads the configuration file into 'Configuration'
+         *
+         * @return: When the configuration is usable, 'true' is returned,
+         *          otherwise a message is printed
+         */
+        bool loadConfiguration();
+
+        /**
+         * @name:   Create Pump
+         * @brief:  Tracer, in-process body & an initialized pump
+         *
+         *  The pump gets the configuration as it is at this call
+         *
+         * @return: The pump, owned by the harness
+         */
+        Pump &createPump();
+
+        /**
+         * @name:   Configuration
+         * @brief:  The configuration of the run, may be changed
+         *          before createPump()
+         */
+        config Configuration;
+
+        /**
+         * @name:   The Tracer / The Body / Transport / The Pump
+         * @brief:  The stack created by createPump(), NULL before
+         */
+        Tracer *TheTracer;
+        Body *TheBody;
+        InProcessTransport *Transport;
+        Pump *ThePump;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file:   InProcessTransport.cpp
+ * @class:  InProcessTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump directly linked to a Body model in the same process
+ *          No I/O, values are handed over as they are
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "InProcessTransport.h"
+
+using namespace std;
+
+
+
+/* Connects the pump to a body model
+ */
+InProcessTransport::InProcessTransport(Body *body, float bodyFactor, bool rising)
+{
+    TheBody = body;
+    BodyFactor = bodyFactor;
+    Rising = rising;
+    InsulinUnits = 0;
+    GlucagonUnits = 0;
+}
+
+
+/* Reads the blood sugar level of the body model
+ */
+int InProcessTransport::readBloodSugarLevel()
+{
+    return (int)TheBody->getBloodSugarLevel();
+}
+
+/* Lets the body step with the pending units, then takes the new ones
+ */
+void InProcessTransport::injectHormones(int insulinUnits, int glucagonUnits)
+{
+    TheBody->simulateStep(BodyFactor, Rising, InsulinUnits, GlucagonUnits);
+
+    InsulinUnits = insulinUnits;
+    GlucagonUnits = glucagonUnits;
+}
+
+
+/* Getter & Setter for the behaviour of the body model
+ */
+void InProcessTransport::setBodyFactor(float factor, bool rising)
+{
+    BodyFactor = factor;
+    Rising = rising;
+}
+
+float InProcessTransport::getBodyFactor() const
+{
+    return BodyFactor;
+}
+
+bool InProcessTransport::getRising() const
+{
+    return Rising;
+}
+
+/* Returns the connected body model
+ */
+Body *InProcessTransport::getBody() const
+{
+    return TheBody;
+}
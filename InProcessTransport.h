@@ -0,0 +1,105 @@
+/**
+ * @file:   InProcessTransport.h
+ * @class:  InProcessTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump directly linked to a Body model in the same process
+ *          No I/O, values are handed over as they are
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef inprocesstransport_
+#define inprocesstransport_
+
+#include "Body.h"
+#include "Transport.h"
+
+
+#define INPROCESS_BODY_BSL          110.00  // like the Body target
+#define INPROCESS_INSULIN_CONSTANT  5
+#define INPROCESS_GLUCAGON_CONSTANT 5
+#define INPROCESS_BODY_FACTOR       1.03
+
+
+
+class InProcessTransport : public SensorTransport, public InjectionTransport
+{
+    public:
+        /**
+         * @name:   In Process Transport
+         * @brief:  In Process Transport Constructor
+         *
+         * @param:  The body model the pump is connected to
+         * @param:  The factor the BSL is rising or falling per step
+         * @param:  'true' if the BSL is rising
+         */
+        InProcessTransport(Body *body, float bodyFactor, bool rising);
+
+        /**
+         * @name:   Read Blood Sugar Level
+         * @brief:  Reads the blood sugar level of the body model
+         *
+         * @return: The blood sugar level in mg/dL
+         */
+        virtual int readBloodSugarLevel();
+
+        /**
+         * @name:   Inject Hormones
+         * @brief:  Lets the body do one step and hands over the units
+         *
+         *  Same order as BSL_Sim_thread: the body steps with the
+         *  units pending from the last injection before it takes
+         *  the new ones
+         *
+         * @param:  Units of insulin to inject
+         * @param:  Units of glucagon to inject
+         */
+        virtual void injectHormones(int insulinUnits, int glucagonUnits);
+
+        /**
+         * @name:   Get/Set Body Factor, Rising
+         * @brief:  Get/Set the behaviour of the body model
+         *
+         * @param:  The factor the BSL is rising or falling per step
+         * @param:  'true' if the BSL is rising
+         */
+        virtual void setBodyFactor(float factor, bool rising);
+        virtual float getBodyFactor() const;
+        virtual bool getRising() const;
+
+        /**
+         * @name:   Get Body
+         * @brief:  Get the connected body model
+         *
+         * @return: A pointer to the body model
+         */
+        virtual Body *getBody() const;
+
+    private:
+        /**
+         * @name:   The Body
+         * @brief:  The connected body model
+         */
+        Body *TheBody;
+
+        /**
+         * @name:   Body Factor, Rising
+         * @brief:  Behaviour of the body model, see Body::changeBloodSugarLevel()
+         */
+        float BodyFactor;
+        bool Rising;
+
+        /**
+         * @name:   Pending Units
+         * @brief:  Units of the last injection, used up one per step
+         */
+        int InsulinUnits;
+        int GlucagonUnits;
+};
+
+#endif
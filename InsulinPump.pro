@@ -13,22 +13,64 @@ TEMPLATE = app
 
 CONFIG += c++11
 
-LIBS += -pthread
+LIBS += -pthread -lrt
+
+INCLUDEPATH += Body
 
 SOURCES +=\
     ControlSystem.cpp \
+    AlarmEngine.cpp \
+    ParameterSweep.cpp \
+    OperationTimeJournal.cpp \
     Pump.cpp \
+    PumpTrace.cpp \
     Scheduler.cpp \
+    SharedMemoryRing.cpp \
     Tracer.cpp \
+    Transport.cpp \
+    FileTransport.cpp \
+    SharedMemoryTransport.cpp \
+    SocketTransport.cpp \
+    InProcessTransport.cpp \
+    AdaptiveInterval.cpp \
+    Clock.cpp \
+    RealTime.cpp \
+    JobExecutor.cpp \
+    LatencyHistogram.cpp \
+    UnixSocketChannel.cpp \
+    WireProtocol.cpp \
+    WorkStealingPool.cpp \
+    Headless.cpp \
+    Body/Body.cpp \
     UserInterface.cpp \
     main.cpp
 
 HEADERS  += \
+    OperationTimeJournal.h \
+    ParameterSweep.h \
     Pump.h \
+    PumpTrace.h \
     Scheduler.h \
+    SharedMemoryRing.h \
     Tracer.h \
+    Transport.h \
+    FileTransport.h \
+    SharedMemoryTransport.h \
+    SocketTransport.h \
+    InProcessTransport.h \
+    AdaptiveInterval.h \
+    Clock.h \
+    RealTime.h \
+    JobExecutor.h \
+    LatencyHistogram.h \
+    UnixSocketChannel.h \
+    WireProtocol.h \
+    WorkStealingPool.h \
+    Headless.h \
+    Body/Body.h \
     UserInterface.h \
     ControlSystem.h \
+    AlarmEngine.h \
     Config.h
 
 FORMS    += \
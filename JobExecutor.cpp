@@ -0,0 +1,702 @@
+/**
+ * @file:   JobExecutor.cpp
+ * @class:  JobExecutor
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Runs periodic jobs on a fixed number of threads
+ *          Jobs have a period, a priority and a deadline
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "JobExecutor.h"
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+using namespace std;
+
+
+
+/* The constructor starts without jobs & threads
+ */
+JobExecutor::JobExecutor(Clock *clock) :
+    Running(false),
+    Shared(0),
+    Live(0),
+    LowBusy(0),
+    Tickless(false),
+    TimerHeld(false),
+    TimerFd(-1),
+    EventFd(-1),
+    EpollFd(-1),
+    Wakeups(0),
+    TheClock(clock ? clock : Clock::getRealClock())
+{
+}
+
+/* The destructor joins the threads
+ */
+JobExecutor::~JobExecutor()
+{
+    stop();
+}
+
+
+/* Registers a job, released for the first time now
+ */
+int JobExecutor::addJob(string name, function<void()> job, int periodMs,
+                        int priority, int deadlineMs)
+{
+    periodicjob entry;
+    entry.name = name;
+    entry.run = job;
+    entry.period = chrono::milliseconds(periodMs > 0 ? periodMs : 1);
+    entry.deadline = chrono::milliseconds(deadlineMs > 0 ? deadlineMs : 0);
+    entry.priority = priority;
+    entry.release = TheClock->now();
+    entry.running = false;
+    entry.triggered = false;
+    entry.dedicated = false;
+    entry.runs = 0;
+    entry.missed = 0;
+    entry.lateness = make_shared<LatencyHistogram>();
+    entry.execution = make_shared<LatencyHistogram>();
+
+    int number;
+    {
+        lock_guard<mutex> lock(Lock);
+        Jobs.push_back(entry);
+        number = Jobs.size() - 1;
+    }
+    Wakeup.notify_all();
+    DedicatedWakeup.notify_all();
+    notifyTimer();
+
+    return number;
+}
+
+/* Getter & Setter for the period of a job
+ */
+int JobExecutor::getPeriod(int job)
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Jobs[job].period.count();
+}
+
+void JobExecutor::setPeriod(int job, int periodMs)
+{
+    {
+        lock_guard<mutex> lock(Lock);
+        chrono::milliseconds period(periodMs > 0 ? periodMs : 1);
+
+        // a running job takes the new period when it is done
+        if(!Jobs[job].running)
+        {
+            Jobs[job].release += period - Jobs[job].period;
+        }
+        Jobs[job].period = period;
+    }
+    Wakeup.notify_all();
+    DedicatedWakeup.notify_all();
+    notifyTimer();
+}
+
+/* Releases a job now, or again right after its current run
+ */
+void JobExecutor::trigger(int job)
+{
+    {
+        lock_guard<mutex> lock(Lock);
+
+        if(Jobs[job].running)
+        {
+            Jobs[job].triggered = true;
+        }
+        else if(Jobs[job].release > TheClock->now())
+        {
+            Jobs[job].release = TheClock->now();
+        }
+    }
+    Wakeup.notify_all();
+    DedicatedWakeup.notify_all();
+    notifyTimer();
+}
+
+/* A release passed by the given periods, the run not yet booked
+ */
+bool JobExecutor::isOverdue(int job, int periods)
+{
+    lock_guard<mutex> lock(Lock);
+
+    return TheClock->now() > Jobs[job].release + periods * Jobs[job].period;
+}
+
+/* Setter for the function called on missed deadlines
+ */
+void JobExecutor::setMissHandler(function<void(int)> handler)
+{
+    lock_guard<mutex> lock(Lock);
+
+    if(!Running)
+    {
+        MissHandler = handler;
+    }
+}
+
+/* Gives a job its own thread, only before the start
+ */
+void JobExecutor::setDedicated(int job)
+{
+    lock_guard<mutex> lock(Lock);
+
+    if(!Running)
+    {
+        Jobs[job].dedicated = true;
+    }
+}
+
+/* Starts the threads, one per dedicated job & the shared ones,
+ * one of them is kept for the highest priority
+ */
+void JobExecutor::start(int threads)
+{
+    lock_guard<mutex> lock(Lock);
+
+    if(Running)
+    {
+        return;
+    }
+    if(threads < 2)
+    {
+        threads = 2;
+    }
+
+    // the jobs registered so far share the first release
+    chrono::steady_clock::time_point now = TheClock->now();
+    for(size_t i = 0; i < Jobs.size(); i++)
+    {
+        Jobs[i].release = now;
+    }
+
+    if(TheClock->isSimulated() || (Tickless && !openTimer()))
+    {
+        Tickless = false;
+    }
+
+    Running = true;
+    if(TheClock->isSimulated())
+    {
+        return;
+    }
+    for(size_t i = 0; i < Jobs.size(); i++)
+    {
+        if(Jobs[i].dedicated)
+        {
+            Workers.push_back(thread(&JobExecutor::workDedicated, this, (int)i));
+        }
+    }
+    Shared = threads;
+    for(int i = 0; i < threads; i++)
+    {
+        // counted until the thread leaves work(), already before it got there
+        Live++;
+        Workers.push_back(thread(&JobExecutor::work, this));
+    }
+}
+
+/* Wakes and joins the threads, not from within a job
+ */
+void JobExecutor::stop()
+{
+    vector<thread> workers;
+    {
+        lock_guard<mutex> lock(Lock);
+        Running = false;
+        Shared = 0;
+        workers.swap(Workers);
+    }
+    Wakeup.notify_all();
+    DedicatedWakeup.notify_all();
+    notifyTimer();
+
+    for(size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    lock_guard<mutex> lock(Lock);
+    closeTimer();
+}
+
+/* Getter & Setter for the timer
+ */
+bool JobExecutor::isTickless()
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Tickless;
+}
+
+void JobExecutor::setTickless(bool value)
+{
+    lock_guard<mutex> lock(Lock);
+
+    if(!Running)
+    {
+        Tickless = value;
+    }
+}
+
+/* Setter for the function run first by the threads
+ */
+void JobExecutor::setThreadInit(function<void(int)> init)
+{
+    lock_guard<mutex> lock(Lock);
+
+    if(!Running)
+    {
+        ThreadInit = init;
+    }
+}
+
+/* Getter for the wake-up counter
+ */
+uint64_t JobExecutor::getWakeups()
+{
+    return Wakeups.load();
+}
+
+/* Getter for the state of the threads
+ */
+bool JobExecutor::isRunning()
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Running;
+}
+
+int JobExecutor::getThreadCount()
+{
+    return Live.load();
+}
+
+/* Getter for the counters of a job
+ */
+uint64_t JobExecutor::getRuns(int job)
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Jobs[job].runs;
+}
+
+uint64_t JobExecutor::getMissedDeadlines(int job)
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Jobs[job].missed;
+}
+
+/* Getter for the number & the names of the jobs
+ */
+int JobExecutor::getJobCount()
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Jobs.size();
+}
+
+string JobExecutor::getName(int job)
+{
+    lock_guard<mutex> lock(Lock);
+
+    return Jobs[job].name;
+}
+
+/* Getter for the histograms of a job, read without the lock
+ */
+void JobExecutor::getLateness(int job, histogramsummary *summary)
+{
+    shared_ptr<LatencyHistogram> histogram;
+    {
+        lock_guard<mutex> lock(Lock);
+        histogram = Jobs[job].lateness;
+    }
+
+    histogram->getSummary(summary);
+}
+
+void JobExecutor::getExecution(int job, histogramsummary *summary)
+{
+    shared_ptr<LatencyHistogram> histogram;
+    {
+        lock_guard<mutex> lock(Lock);
+        histogram = Jobs[job].execution;
+    }
+
+    histogram->getSummary(summary);
+}
+
+
+/* Main loop of a shared thread: runs released jobs, else waits for the next release
+ */
+void JobExecutor::work()
+{
+    // set before start(), which created this thread
+    if(ThreadInit)
+    {
+        ThreadInit(-1);
+    }
+
+    unique_lock<mutex> lock(Lock);
+
+    while(Running)
+    {
+        chrono::steady_clock::time_point now = TheClock->now();
+        chrono::steady_clock::time_point next = now + chrono::hours(1);
+        int job = pickJob(now, next);
+        if(job < 0)
+        {
+            // tickless: one thread sleeps on the timer, the others until
+            // it hands them the timer or a job
+            if(Tickless && !TimerHeld)
+            {
+                waitTimer(next, lock);
+            }
+            else if(Tickless)
+            {
+                Wakeup.wait(lock);
+            }
+            else
+            {
+                Wakeup.wait_until(lock, next);
+            }
+            Wakeups++;
+            continue;
+        }
+
+        runJob(job, lock);
+    }
+
+    Live--;
+}
+
+/* Main loop of a dedicated thread: runs its job, else waits for its release
+ */
+void JobExecutor::workDedicated(int job)
+{
+    if(ThreadInit)
+    {
+        ThreadInit(job);
+    }
+
+    unique_lock<mutex> lock(Lock);
+
+    while(Running)
+    {
+        chrono::steady_clock::time_point release = Jobs[job].release;
+        if(release > TheClock->now())
+        {
+            DedicatedWakeup.wait_until(lock, release);
+            Wakeups++;
+            continue;
+        }
+
+        runJob(job, lock);
+    }
+}
+
+/* Sleeps in epoll until the next release or a change, the lock is held
+ */
+void JobExecutor::waitTimer(chrono::steady_clock::time_point next, unique_lock<mutex> &lock)
+{
+    // released & running jobs come back one period later, unless late
+    chrono::steady_clock::time_point now = TheClock->now();
+    for(size_t i = 0; i < Jobs.size(); i++)
+    {
+        chrono::steady_clock::time_point again = Jobs[i].release + Jobs[i].period;
+        if(!Jobs[i].dedicated && Jobs[i].release <= now && again > now && again < next)
+        {
+            next = again;
+        }
+    }
+    Armed = next;
+    TimerHeld = true;
+    lock.unlock();
+
+    // absolute on CLOCK_MONOTONIC, the clock of steady_clock, 0 would disarm
+    long long at = chrono::duration_cast<chrono::nanoseconds>(next.time_since_epoch()).count();
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = at / 1000000000;
+    spec.it_value.tv_nsec = at > 0 ? at % 1000000000 : 1;
+
+    struct epoll_event events[2];
+    if(timerfd_settime(TimerFd, TFD_TIMER_ABSTIME, &spec, NULL) < 0 ||
+       (epoll_wait(EpollFd, events, 2, -1) < 0 && errno != EINTR))
+    {
+        // the descriptors are unusable, wait like without the timer
+        this_thread::sleep_until(next);
+    }
+
+    uint64_t expirations;
+    while(read(TimerFd, &expirations, sizeof(expirations)) > 0);
+    while(read(EventFd, &expirations, sizeof(expirations)) > 0);
+
+    lock.lock();
+    TimerHeld = false;
+}
+
+/* The timerfd & the eventfd, both non blocking, in one epoll
+ */
+bool JobExecutor::openTimer()
+{
+    TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    EventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    EpollFd = epoll_create1(EPOLL_CLOEXEC);
+    if(TimerFd < 0 || EventFd < 0 || EpollFd < 0)
+    {
+        closeTimer();
+        return false;
+    }
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = TimerFd;
+    if(epoll_ctl(EpollFd, EPOLL_CTL_ADD, TimerFd, &event) < 0)
+    {
+        closeTimer();
+        return false;
+    }
+    event.data.fd = EventFd;
+    if(epoll_ctl(EpollFd, EPOLL_CTL_ADD, EventFd, &event) < 0)
+    {
+        closeTimer();
+        return false;
+    }
+
+    return true;
+}
+
+void JobExecutor::closeTimer()
+{
+    int *fds[] = { &TimerFd, &EventFd, &EpollFd };
+
+    for(int i = 0; i < 3; i++)
+    {
+        if(*fds[i] >= 0)
+        {
+            close(*fds[i]);
+            *fds[i] = -1;
+        }
+    }
+}
+
+/* Wakes the thread on the timer, a no-op without it
+ */
+void JobExecutor::notifyTimer()
+{
+    uint64_t one = 1;
+
+    lock_guard<mutex> lock(Lock);
+    if(EventFd >= 0)
+    {
+        if(write(EventFd, &one, sizeof(one)) < 0)
+        {
+            // the counter is full, the loop is woken anyway
+        }
+    }
+}
+
+/* Discrete event loop: runs released jobs, else jumps to the next release
+ */
+void JobExecutor::simulate(chrono::steady_clock::time_point until)
+{
+    unique_lock<mutex> lock(Lock);
+
+    while(Running && TheClock->isSimulated())
+    {
+        chrono::steady_clock::time_point now = TheClock->now();
+        chrono::steady_clock::time_point next = until;
+        int job = pickJob(now, next);
+        if(job >= 0)
+        {
+            runJob(job, lock);
+        }
+        else if(now < until)
+        {
+            TheClock->advanceTo(next);
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/* Runs a job unlocked & books its run, deadline and next release
+ */
+void JobExecutor::runJob(int job, unique_lock<mutex> &lock)
+{
+    // the jobs may grow while unlocked, so by number only
+    bool dedicated = Jobs[job].dedicated && !Workers.empty();
+    bool low = !dedicated && Jobs[job].priority < topPriority();
+    function<void()> run = Jobs[job].run;
+    shared_ptr<LatencyHistogram> lateness = Jobs[job].lateness;
+    shared_ptr<LatencyHistogram> execution = Jobs[job].execution;
+    chrono::steady_clock::time_point release = Jobs[job].release;
+    Jobs[job].running = true;
+    if(low)
+    {
+        LowBusy++;
+    }
+
+    // tickless, leader/follower: a waiting thread takes over the timer
+    // while the job runs here, or the second released job
+    chrono::steady_clock::time_point next = release + chrono::hours(1);
+    if(Tickless && !dedicated && (!TimerHeld || pickJob(TheClock->now(), next) >= 0))
+    {
+        Wakeup.notify_one();
+    }
+
+    lock.unlock();
+    chrono::steady_clock::time_point start = TheClock->now();
+    lateness->record(start > release ?
+                     chrono::duration_cast<chrono::microseconds>(start - release).count() : 0);
+    run();
+    execution->record(chrono::duration_cast<chrono::microseconds>(
+                      TheClock->now() - start).count());
+    lock.lock();
+
+    if(low)
+    {
+        LowBusy--;
+    }
+
+    periodicjob &done = Jobs[job];
+    chrono::milliseconds deadline = done.deadline.count() > 0 ? done.deadline : done.period;
+    chrono::steady_clock::time_point now = TheClock->now();
+    uint64_t missed = done.missed;
+    if(now > done.release + deadline)
+    {
+        done.missed++;
+    }
+    done.runs++;
+    done.running = false;
+
+    // no burst after an overrun, releases older than a period are skipped
+    done.release += done.period;
+    if(now - done.release >= done.period)
+    {
+        uint64_t skipped = (now - done.release) / done.period;
+        done.missed += skipped;
+        done.release += skipped * done.period;
+    }
+
+    // an event during the run: once more, now
+    if(done.triggered)
+    {
+        done.triggered = false;
+        done.release = now;
+    }
+
+    bool booked_miss = done.missed != missed;
+
+    // tickless: this thread picks the next job or takes the timer itself,
+    // the thread on the timer only has to know about an earlier release
+    if(dedicated)
+    {
+        // no shared thread waits for this one
+    }
+    else if(Tickless)
+    {
+        if(TimerHeld && done.release < Armed)
+        {
+            // the other jobs of this release need no further wake-up
+            Armed = done.release;
+            lock.unlock();
+            notifyTimer();
+            lock.lock();
+        }
+    }
+    else
+    {
+        // a low priority job may have waited for this thread
+        Wakeup.notify_all();
+    }
+
+    // last, the jobs may grow while unlocked
+    if(booked_miss && MissHandler)
+    {
+        function<void(int)> handler = MissHandler;
+        lock.unlock();
+        handler(job);
+        lock.lock();
+    }
+}
+
+/* Picks the released job with the highest priority, then the earliest release
+ */
+int JobExecutor::pickJob(chrono::steady_clock::time_point now,
+                         chrono::steady_clock::time_point &next)
+{
+    int top = topPriority();
+    // without threads (simulated) the jobs run one after the other
+    bool low_allowed = Shared == 0 || LowBusy < Shared - 1;
+    int best = -1;
+
+    for(size_t i = 0; i < Jobs.size(); i++)
+    {
+        const periodicjob &job = Jobs[i];
+        if(job.running || (job.dedicated && !Workers.empty()))
+        {
+            continue;
+        }
+        if(job.release > now)
+        {
+            next = job.release < next ? job.release : next;
+            continue;
+        }
+        if(job.priority < top && !low_allowed)
+        {
+            // woken up when a thread becomes free
+            continue;
+        }
+        if(best < 0 || job.priority > Jobs[best].priority ||
+           (job.priority == Jobs[best].priority && job.release < Jobs[best].release))
+        {
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+/* The highest priority of all jobs
+ */
+int JobExecutor::topPriority()
+{
+    int top = 0;
+    bool found = false;
+
+    for(size_t i = 0; i < Jobs.size(); i++)
+    {
+        if(Jobs[i].dedicated)
+        {
+            continue;
+        }
+        if(!found || Jobs[i].priority > top)
+        {
+            top = Jobs[i].priority;
+            found = true;
+        }
+    }
+
+    return top;
+}
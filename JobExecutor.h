@@ -0,0 +1,389 @@
+/**
+ * @file:   JobExecutor.h
+ * @class:  JobExecutor
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Runs periodic jobs on a fixed number of threads
+ *          Jobs have a period, a priority and a deadline
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef jobexecutor_
+#define jobexecutor_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Clock.h"
+#include "LatencyHistogram.h"
+
+
+
+class JobExecutor
+{
+    public:
+        /**
+         * @name:   Job Executor
+         * @brief:  Job Executor Constructor
+         *
+         *  No threads are started before start()
+         *
+         * @param:  The clock of the releases, NULL for the real clock
+         */
+        JobExecutor(Clock *clock = NULL);
+
+        /**
+         * @name:   ~Job Executor
+         * @brief:  Job Executor Destructor
+         *
+         *  Stops and joins the threads
+         */
+        ~JobExecutor();
+
+        /**
+         * @name:   Add Job
+         * @brief:  Registers a periodic job, also while running
+         *
+         *  The first release is now, for the jobs added before start()
+         *  it is the start, so jobs of the same period wake up together.
+         *  A job never runs on two threads at
+         *  the same time. Releases that passed by more than a period while
+         *  the job was still running are skipped, not caught up.
+         *
+         * @param:  The name of the job
+         * @param:  The job
+         * @param:  The period in milliseconds
+         * @param:  The priority, higher runs first
+         * @param:  The deadline in milliseconds after the release, 0 for the period
+         * @return: The number of the job
+         */
+        int addJob(std::string name, std::function<void()> job, int periodMs,
+                   int priority, int deadlineMs);
+
+        /**
+         * @name:   Get/Set Period
+         * @brief:  Get/Set the period of a job in milliseconds
+         *
+         *  A new period takes effect at once, the next release moves to the
+         *  last release plus the new period
+         *
+         * @param:  The number of the job
+         * @param:  The period in milliseconds
+         * @return: The period in milliseconds
+         */
+        int getPeriod(int job);
+        void setPeriod(int job, int periodMs);
+
+        /**
+         * @name:   Trigger
+         * @brief:  Releases a job now, out of its period
+         *
+         *  For events. A running job runs once more when it is done.
+         *  The following releases count from the triggered one.
+         *
+         * @param:  The number of the job
+         */
+        void trigger(int job);
+
+        /**
+         * @name:   Is Overdue
+         * @brief:  Checks if a job is stuck, running or waiting
+         *
+         * @param:  The number of the job
+         * @param:  The number of periods after the release
+         * @return: When that many periods passed since the release
+         *          without the run being booked, 'true' is returned
+         */
+        bool isOverdue(int job, int periods);
+
+        /**
+         * @name:   Set Miss Handler
+         * @brief:  Sets a function called when a job missed deadlines
+         *
+         *  Called without the lock by the thread that booked the miss.
+         *  Set before start().
+         *
+         * @param:  The function, gets the number of the job, empty for none
+         */
+        void setMissHandler(std::function<void(int)> handler);
+
+        /**
+         * @name:   Set Dedicated
+         * @brief:  Gives a job a thread of its own
+         *
+         *  The thread only runs this job and waits for its releases by
+         *  itself, the shared threads never run it. For a job that must
+         *  not share a thread, its priority or CPU with the others.
+         *  Set before start().
+         *
+         * @param:  The number of the job
+         */
+        void setDedicated(int job);
+
+        /**
+         * @name:   Start
+         * @brief:  Starts the threads
+         *
+         *  Starts a thread for each dedicated job and the shared threads.
+         *  One shared thread is always kept for the shared jobs of the
+         *  highest priority, the others may only use the rest of them.
+         *  With a simulated clock no threads are started, the jobs
+         *  only run in simulate().
+         *
+         * @param:  The number of shared threads, at least 2
+         */
+        void start(int threads);
+
+        /**
+         * @name:   Get/Set Tickless
+         * @brief:  Get/Set if the idle threads share one timer
+         *
+         *  Tickless: one idle thread sleeps in epoll on a timerfd armed to
+         *  the next release, the others until a second released job or a
+         *  job below the highest priority needs them. Otherwise every
+         *  thread waits for the next release itself. Set before start(),
+         *  without a timerfd the threads wait for the next release.
+         *
+         * @param:  'true' for the timer
+         * @return: When the timer is used, 'true' is returned
+         */
+        bool isTickless();
+        void setTickless(bool value);
+
+        /**
+         * @name:   Set Thread Init
+         * @brief:  Sets a function run first by every thread of start()
+         *
+         *  For settings of the threads themselves, like the priority.
+         *  Set before start().
+         *
+         * @param:  The function, gets the dedicated job of the thread or
+         *          -1 for a shared thread, empty for none
+         */
+        void setThreadInit(std::function<void(int)> init);
+
+        /**
+         * @name:   Get Wakeups
+         * @brief:  Number of times an idle thread woke up
+         *
+         * @return: The wake-ups since the construction
+         */
+        uint64_t getWakeups();
+
+        /**
+         * @name:   Simulate
+         * @brief:  Runs the jobs in simulated time, on the calling thread
+         *
+         *  Discrete events: the simulated clock jumps from release to
+         *  release, the jobs take no simulated time. Returns at the end
+         *  time or when stopped, does nothing with the real clock.
+         *
+         * @param:  The end of the simulation on the clock
+         */
+        void simulate(std::chrono::steady_clock::time_point until);
+
+        /**
+         * @name:   Stop
+         * @brief:  Wakes and joins the threads
+         *
+         *  Running jobs are finished, no new ones are started
+         */
+        void stop();
+
+        /**
+         * @name:   Is Running / Get Thread Count
+         * @brief:  Checks if the threads are started
+         *
+         * @return: When the threads run, 'true' is returned / the number of
+         *          shared threads in their main loop
+         */
+        bool isRunning();
+        int getThreadCount();
+
+        /**
+         * @name:   Get Runs / Missed Deadlines
+         * @brief:  Counters of a job
+         *
+         *  A deadline is missed when a run finished after it or when
+         *  a release was skipped
+         *
+         * @param:  The number of the job
+         * @return: The number of finished runs / missed deadlines
+         */
+        uint64_t getRuns(int job);
+        uint64_t getMissedDeadlines(int job);
+
+        /**
+         * @name:   Get Job Count / Name
+         * @brief:  Number of registered jobs / name of a job
+         *
+         * @param:  The number of the job
+         * @return: The number of jobs / the name of the job
+         */
+        int getJobCount();
+        std::string getName(int job);
+
+        /**
+         * @name:   Get Lateness / Execution
+         * @brief:  Histograms of a job in microseconds
+         *
+         *  Lateness is the time from the release to the start of a run
+         *  (wake-up jitter plus waiting for a thread), execution the time
+         *  the run took. Recorded lock free by the running thread.
+         *
+         * @param:  The number of the job
+         * @param:  Receives count, p50, p99, p999 and max
+         */
+        void getLateness(int job, histogramsummary *summary);
+        void getExecution(int job, histogramsummary *summary);
+
+    private:
+        /**
+         * @name:   Periodic Job
+         * @brief:  A registered job and its state
+         *
+         *  Release is the next release while the job waits,
+         *  the current one while it runs
+         */
+        struct periodicjob{
+            std::string name;
+            std::function<void()> run;
+            std::chrono::milliseconds period;
+            std::chrono::milliseconds deadline;     // 0: the period
+            int priority;
+            std::chrono::steady_clock::time_point release;
+            bool running;
+            bool triggered;
+            bool dedicated;     // on a thread of its own
+            uint64_t runs;
+            uint64_t missed;
+            std::shared_ptr<LatencyHistogram> lateness;
+            std::shared_ptr<LatencyHistogram> execution;
+        };
+
+        std::vector<periodicjob> Jobs;
+        std::vector<std::thread> Workers;
+
+        /**
+         * @name:   Lock & Wakeup
+         * @brief:  Protect the jobs, wake the shared / dedicated
+         *          threads on changes
+         */
+        std::mutex Lock;
+        std::condition_variable Wakeup;
+        std::condition_variable DedicatedWakeup;
+
+        /**
+         * @name:   Running / Shared / Live / Low Busy / Thread Init / Miss Handler
+         * @brief:  Flag for the threads / number of shared threads /
+         *          shared threads started & not yet out of work() /
+         *          shared threads running a job below the highest
+         *          priority / run first by them / called on missed deadlines
+         */
+        bool Running;
+        int Shared;
+        std::atomic<int> Live;
+        int LowBusy;
+        std::function<void(int)> ThreadInit;
+        std::function<void(int)> MissHandler;
+
+        /**
+         * @name:   Tickless / Timer
+         * @brief:  Flag of the timer, a thread sleeps on it, its timerfd,
+         *          eventfd for changes, epoll descriptor and armed release
+         */
+        bool Tickless;
+        bool TimerHeld;
+        int TimerFd;
+        int EventFd;
+        int EpollFd;
+        std::chrono::steady_clock::time_point Armed;
+        std::atomic<uint64_t> Wakeups;
+
+        /**
+         * @name:   The Clock
+         * @brief:  Time source of the releases
+         */
+        Clock *TheClock;
+
+        /**
+         * @name:   Work
+         * @brief:  Main loop of one shared thread
+         */
+        void work();
+
+        /**
+         * @name:   Work Dedicated
+         * @brief:  Main loop of the thread of a dedicated job
+         *
+         * @param:  The number of the job
+         */
+        void workDedicated(int job);
+
+        /**
+         * @name:   Wait Timer
+         * @brief:  Sleeps on the timer until the next release or a change
+         *
+         *  Arms the timerfd to the next release, also of the released and
+         *  running jobs, the lock is released while sleeping
+         *
+         * @param:  The earliest release of the waiting jobs
+         * @param:  The held lock
+         */
+        void waitTimer(std::chrono::steady_clock::time_point next,
+                       std::unique_lock<std::mutex> &lock);
+
+        /**
+         * @name:   Open/Close/Notify Timer
+         * @brief:  Creates/closes the descriptors of the timer,
+         *          wakes the thread sleeping on it
+         *
+         * @return: When the descriptors could be created, 'true' is returned
+         */
+        bool openTimer();
+        void closeTimer();
+        void notifyTimer();
+
+        /**
+         * @name:   Run Job
+         * @brief:  Runs a picked job without the lock, then books it
+         *
+         * @param:  The number of the job
+         * @param:  The held lock, released while the job runs
+         */
+        void runJob(int job, std::unique_lock<std::mutex> &lock);
+
+        /**
+         * @name:   Pick Job
+         * @brief:  The released job to run next, the lock is held
+         *
+         *  Highest priority first, then the earliest release. With
+         *  threads, for the shared ones: dedicated jobs are left out.
+         *
+         * @param:  The current time
+         * @param:  Receives the earliest release of the waiting jobs
+         * @return: The number of the job, -1 if none can run now
+         */
+        int pickJob(std::chrono::steady_clock::time_point now,
+                    std::chrono::steady_clock::time_point &next);
+
+        /**
+         * @name:   Top Priority
+         * @brief:  The highest priority of the shared jobs, the lock is held
+         */
+        int topPriority();
+};
+
+#endif
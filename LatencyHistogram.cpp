@@ -0,0 +1,133 @@
+/**
+ * @file:   LatencyHistogram.cpp
+ * @class:  LatencyHistogram
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Lock free log-linear histogram of latencies in microseconds
+ *          Percentiles with a relative error below 1/16
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "LatencyHistogram.h"
+#include <math.h>
+
+using namespace std;
+
+
+
+/* The constructor clears all buckets
+ */
+LatencyHistogram::LatencyHistogram() :
+    Count(0),
+    Max(0)
+{
+    for(int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        Counts[i] = 0;
+    }
+}
+
+
+/* Counts a value, only relaxed atomics
+ */
+void LatencyHistogram::record(uint64_t value)
+{
+    Counts[bucketOf(value)].fetch_add(1, memory_order_relaxed);
+    Count.fetch_add(1, memory_order_relaxed);
+
+    uint64_t max = Max.load(memory_order_relaxed);
+    while(value > max && !Max.compare_exchange_weak(max, value, memory_order_relaxed))
+    {
+        // another thread raised the max, compare again
+    }
+}
+
+/* Getter for the number of values & the largest one
+ */
+uint64_t LatencyHistogram::getCount() const
+{
+    return Count.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMax() const
+{
+    return Max.load(memory_order_relaxed);
+}
+
+/* Walks the buckets up to the rank of the percentile
+ */
+uint64_t LatencyHistogram::getPercentile(double percent) const
+{
+    uint64_t count = getCount();
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)ceil(percent / 100.0 * count);
+    rank = rank < 1 ? 1 : rank;
+
+    uint64_t seen = 0;
+    uint64_t max = getMax();
+    for(int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += Counts[i].load(memory_order_relaxed);
+        if(seen >= rank)
+        {
+            return upperBound(i) < max ? upperBound(i) : max;
+        }
+    }
+
+    return max;
+}
+
+/* Count, percentiles & max at once
+ */
+void LatencyHistogram::getSummary(histogramsummary *summary) const
+{
+    summary->count = getCount();
+    summary->p50 = getPercentile(50.0);
+    summary->p99 = getPercentile(99.0);
+    summary->p999 = getPercentile(99.9);
+    summary->max = getMax();
+}
+
+
+/* Linear below 16, 16 buckets per power of two above
+ */
+int LatencyHistogram::bucketOf(uint64_t value)
+{
+    if(value < HISTOGRAM_SUB_BUCKETS)
+    {
+        return (int)value;
+    }
+
+    int msb = 63 - __builtin_clzll(value);
+    if(msb >= HISTOGRAM_MAX_BITS)
+    {
+        return HISTOGRAM_BUCKETS - 1;
+    }
+
+    int shift = msb - HISTOGRAM_SUB_BITS;
+    int sub = (int)((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::upperBound(int bucket)
+{
+    if(bucket < HISTOGRAM_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    int shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t sub = bucket % HISTOGRAM_SUB_BUCKETS;
+
+    return ((HISTOGRAM_SUB_BUCKETS + sub) << shift) + ((uint64_t)1 << shift) - 1;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file:   LatencyHistogram.h
+ * @class:  LatencyHistogram
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Lock free log-linear histogram of latencies in microseconds
+ *          Percentiles with a relative error below 1/16
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef latencyhistogram_
+#define latencyhistogram_
+
+#include <atomic>
+#include <stdint.h>
+
+
+#define HISTOGRAM_SUB_BITS      4                               // linear buckets per power of two: 2^4
+#define HISTOGRAM_SUB_BUCKETS   (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BITS      40                              // larger values count as 2^40 us (12 days)
+#define HISTOGRAM_BUCKETS       ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+
+/**
+ * @name        Histogram Summary
+ * @brief       Snapshot of a histogram, values in microseconds
+ *
+ *  Count       Number of recorded values
+ *  P50         Median
+ *  P99         99th percentile
+ *  P999        99.9th percentile
+ *  Max         Largest recorded value (exact)
+ */
+struct histogramsummary{
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+
+
+class LatencyHistogram
+{
+    public:
+        /**
+         * @name:   Latency Histogram
+         * @brief:  Latency Histogram Constructor
+         *
+         *  All buckets start empty
+         */
+        LatencyHistogram();
+
+        /**
+         * @name:   Record
+         * @brief:  Counts a value, lock free, from any thread
+         *
+         *  Values below 16 have their own bucket, above that every power
+         *  of two is split into 16 buckets of equal width
+         *
+         * @param:  The value in microseconds
+         */
+        void record(uint64_t value);
+
+        /**
+         * @name:   Get Count / Max
+         * @brief:  Number of recorded values / largest recorded value
+         *
+         * @return: The number of values / the largest value
+         */
+        uint64_t getCount() const;
+        uint64_t getMax() const;
+
+        /**
+         * @name:   Get Percentile
+         * @brief:  The value below or at which the given share of values lies
+         *
+         *  Reported as the upper end of its bucket, never above the max.
+         *  Values recorded meanwhile may or may not be included.
+         *
+         * @param:  The percentile, e.g. 99.9
+         * @return: The value in microseconds, 0 if there are none
+         */
+        uint64_t getPercentile(double percent) const;
+
+        /**
+         * @name:   Get Summary
+         * @brief:  Count, p50, p99, p999 and max at once
+         *
+         * @param:  Receives the summary
+         */
+        void getSummary(histogramsummary *summary) const;
+
+    private:
+        /**
+         * @name:   Bucket Of / Upper Bound
+         * @brief:  Bucket of a value / largest value of a bucket
+         */
+        static int bucketOf(uint64_t value);
+        static uint64_t upperBound(int bucket);
+
+        std::atomic<uint64_t> Counts[HISTOGRAM_BUCKETS];
+        std::atomic<uint64_t> Count;
+        std::atomic<uint64_t> Max;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file:   OperationTimeJournal.cpp
+ * @class:  OperationTimeJournal
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Crash safe persistence of the total operation time
+ *          Append-only journal, separate from the static configuration
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "OperationTimeJournal.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+
+
+/* The constructor opens the journal and recovers the last valid record
+ */
+OperationTimeJournal::OperationTimeJournal(const char *filename)
+{
+    FileName = filename;
+    Records = 0;
+    Value = false;
+    Milliseconds = 0;
+    Committed = 0;
+    LastCommit = chrono::steady_clock::now();
+
+    File = open(filename, O_RDWR | O_CREAT, 0644);
+    if(File < 0)
+    {
+        return;
+    }
+
+    struct stat info;
+    vector<journalrecord> records;
+    if(fstat(File, &info) == 0 && info.st_size >= (off_t)sizeof(journalrecord))
+    {
+        records.resize(info.st_size / sizeof(journalrecord));
+        ssize_t got = pread(File, &records[0], records.size() * sizeof(journalrecord), 0);
+        records.resize(got > 0 ? got / sizeof(journalrecord) : 0);
+    }
+
+    // everything from the first bad record on was not completely written
+    for(size_t i = 0; i < records.size(); i++)
+    {
+        if(records[i].magic != JOURNAL_MAGIC ||
+           records[i].checksum != checksum(records[i].milliseconds))
+        {
+            break;
+        }
+        Milliseconds = records[i].milliseconds;
+        Value = true;
+        Records++;
+    }
+    Committed = Milliseconds;
+
+    if(ftruncate(File, (off_t)Records * sizeof(journalrecord)) != 0 ||
+       lseek(File, 0, SEEK_END) < 0)
+    {
+        close(File);
+        File = -1;
+    }
+}
+
+/* The destructor commits the pending time
+ */
+OperationTimeJournal::~OperationTimeJournal()
+{
+    if(File >= 0)
+    {
+        commit();
+        close(File);
+    }
+}
+
+
+/* Checks if the journal could be opened
+ */
+bool OperationTimeJournal::isValid() const
+{
+    return File >= 0;
+}
+
+/* Getter for the recovered or last updated time
+ */
+bool OperationTimeJournal::hasValue() const
+{
+    return Value;
+}
+
+uint64_t OperationTimeJournal::getMilliseconds() const
+{
+    return Milliseconds;
+}
+
+/* Keeps the time in memory, commits once per JOURNAL_COMMIT_MS
+ */
+void OperationTimeJournal::update(uint64_t milliseconds)
+{
+    Milliseconds = milliseconds;
+    Value = true;
+
+    if(chrono::steady_clock::now() - LastCommit >= chrono::milliseconds(JOURNAL_COMMIT_MS))
+    {
+        commit();
+    }
+}
+
+/* Appends one record for all updates since the last commit
+ */
+bool OperationTimeJournal::commit()
+{
+    LastCommit = chrono::steady_clock::now();
+
+    if(File < 0)
+    {
+        return false;
+    }
+    if(!Value || (Records > 0 && Milliseconds == Committed))
+    {
+        return true;
+    }
+
+    journalrecord record;
+    record.magic = JOURNAL_MAGIC;
+    record.checksum = checksum(Milliseconds);
+    record.milliseconds = Milliseconds;
+
+    if(write(File, &record, sizeof(record)) != (ssize_t)sizeof(record))
+    {
+        // no partial record in front of the next one
+        if(ftruncate(File, (off_t)Records * sizeof(journalrecord)) == 0)
+        {
+            lseek(File, 0, SEEK_END);
+        }
+        return false;
+    }
+    Records++;
+
+    // the record stays, the time counts as committed only once it is synced
+    if(fdatasync(File) != 0)
+    {
+        return false;
+    }
+    Committed = record.milliseconds;
+
+    if(Records >= JOURNAL_COMPACT_RECORDS)
+    {
+        return compact();
+    }
+
+    return true;
+}
+
+/* Rewrites the journal with only the committed time
+ */
+bool OperationTimeJournal::compact()
+{
+    string temporary = FileName + ".tmp";
+    journalrecord record;
+    record.magic = JOURNAL_MAGIC;
+    record.checksum = checksum(Committed);
+    record.milliseconds = Committed;
+
+    int file = open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(file < 0)
+    {
+        return false;
+    }
+    if(write(file, &record, sizeof(record)) != (ssize_t)sizeof(record) ||
+       fsync(file) != 0 || rename(temporary.c_str(), FileName.c_str()) != 0)
+    {
+        close(file);
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    // the rename itself has to reach the disk as well
+    size_t slash = FileName.rfind('/');
+    string directory = slash == string::npos ? "." : FileName.substr(0, slash + 1);
+    int dir = open(directory.c_str(), O_RDONLY);
+    if(dir >= 0)
+    {
+        fsync(dir);
+        close(dir);
+    }
+
+    close(File);
+    File = file;
+    Records = 1;
+
+    return true;
+}
+
+/* FNV-1a over the milliseconds
+ */
+uint32_t OperationTimeJournal::checksum(uint64_t milliseconds)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(&milliseconds);
+    uint32_t hash = 2166136261u;
+
+    for(size_t i = 0; i < sizeof(milliseconds); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
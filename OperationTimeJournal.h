@@ -0,0 +1,151 @@
+/**
+ * @file:   OperationTimeJournal.h
+ * @class:  OperationTimeJournal
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Crash safe persistence of the total operation time
+ *          Append-only journal, separate from the static configuration
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef operationtimejournal_
+#define operationtimejournal_
+
+#include <chrono>
+#include <stdint.h>
+#include <string>
+
+
+#define JOURNAL_FILE_NAME       "InsulinPump.optime"
+
+#define JOURNAL_MAGIC           0x4d54504f  // "OPTM"
+#define JOURNAL_COMMIT_MS       10000       // updates are coalesced into one record this long
+#define JOURNAL_COMPACT_RECORDS 1024        // records before the journal is rewritten
+
+
+/**
+ * @name        Journal Record
+ * @brief       One committed operation time, in host byte order
+ *
+ *  Magic         JOURNAL_MAGIC
+ *  Checksum      FNV-1a over the milliseconds
+ *  Milliseconds  The total operation time
+ */
+struct journalrecord{
+    uint32_t magic;
+    uint32_t checksum;
+    uint64_t milliseconds;
+};
+
+static_assert(sizeof(journalrecord) == 16, "journalrecord must stay 16 bytes");
+
+
+
+class OperationTimeJournal
+{
+    public:
+        /**
+         * @name:   Operation Time Journal
+         * @brief:  Operation Time Journal Constructor
+         *
+         *  Opens or creates the journal and recovers the last committed
+         *  time. A torn or corrupt record at the end (crash while
+         *  writing) is cut off. The compaction keeps the journal below
+         *  JOURNAL_COMPACT_RECORDS records, so the recovery reads at
+         *  most 16 KiB.
+         *
+         * @param:  The filename of the journal
+         */
+        OperationTimeJournal(const char *filename);
+
+        /**
+         * @name:   ~Operation Time Journal
+         * @brief:  Operation Time Journal Destructor
+         *
+         *  Commits the pending time and closes the journal
+         */
+        ~OperationTimeJournal();
+
+        /**
+         * @name:   Is Valid
+         * @brief:  Checks if the journal could be opened
+         *
+         * @return: When the journal is usable, 'true' is returned
+         */
+        bool isValid() const;
+
+        /**
+         * @name:   Has Value
+         * @brief:  Checks if a time was recovered or committed
+         *
+         * @return: When the journal holds a time, 'true' is returned
+         */
+        bool hasValue() const;
+
+        /**
+         * @name:   Get Milliseconds
+         * @brief:  The last time handed to the journal
+         *
+         * @return: The total operation time in milliseconds
+         */
+        uint64_t getMilliseconds() const;
+
+        /**
+         * @name:   Update
+         * @brief:  Keeps a new total operation time in memory
+         *
+         *  The time is written behind: all updates within JOURNAL_COMMIT_MS
+         *  end up in a single record
+         *
+         * @param:  The total operation time in milliseconds
+         */
+        void update(uint64_t milliseconds);
+
+        /**
+         * @name:   Commit
+         * @brief:  Appends the pending time and syncs it to disk
+         *
+         *  Compacts the journal when it reached JOURNAL_COMPACT_RECORDS
+         *
+         * @return: When the time is on disk, 'true' is returned
+         */
+        bool commit();
+
+    private:
+        /**
+         * @name:   Compact
+         * @brief:  Replaces the journal by one with only the last record
+         *
+         *  Written to a temporary file that is renamed over the journal,
+         *  a crash leaves either the old or the new journal
+         *
+         * @return: When the journal was replaced, 'true' is returned
+         */
+        bool compact();
+
+        /**
+         * @name:   Checksum
+         * @brief:  FNV-1a over the milliseconds of a record
+         */
+        static uint32_t checksum(uint64_t milliseconds);
+
+        std::string FileName;
+        int File;
+        uint32_t Records;
+        bool Value;
+        uint64_t Milliseconds;
+        uint64_t Committed;
+        std::chrono::steady_clock::time_point LastCommit;
+};
+
+
+#endif
+
+
+
+
@@ -0,0 +1,239 @@
+/**
+ * @file:   ParameterSweep.cpp
+ * @class:  ParameterSweep
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Monte Carlo sweep over the therapy parameters
+ *          Every parameter set runs the body scenarios in parallel
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "ParameterSweep.h"
+#include <QFileInfo>
+#include <QStringList>
+#include "InProcessTransport.h"
+#include "Pump.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+
+
+/* Body factor & direction of the options 1-5 of the Body menu
+ */
+static const float ScenarioFactor[SWEEP_SCENARIOS] = { 1.04, 1.02, 1.00, 1.01, 1.05 };
+static const bool ScenarioRising[SWEEP_SCENARIOS] = { true, true, false, false, false };
+
+
+/* In-process body that keeps the statistics of one parameter set
+ */
+class SweepTransport : public InProcessTransport
+{
+    public:
+        SweepTransport(Body *body, float factor, bool rising, long *readings, long *inRange,
+                       long *hypo, long *hyper, long *insulin, long *glucagon) :
+            InProcessTransport(body, factor, rising),
+            Readings(readings), InRange(inRange), Hypo(hypo), Hyper(hyper),
+            Insulin(insulin), Glucagon(glucagon), Below(false), Above(false) {}
+
+        virtual int readBloodSugarLevel()
+        {
+            int level = InProcessTransport::readBloodSugarLevel();
+
+            (*Readings)++;
+            if(level >= SWEEP_RANGE_LOW && level <= SWEEP_RANGE_HIGH)
+            {
+                (*InRange)++;
+            }
+            // Count the excursions, not the readings outside
+            if(level < SWEEP_RANGE_LOW && !Below)
+            {
+                (*Hypo)++;
+            }
+            if(level > SWEEP_RANGE_HIGH && !Above)
+            {
+                (*Hyper)++;
+            }
+            Below = level < SWEEP_RANGE_LOW;
+            Above = level > SWEEP_RANGE_HIGH;
+
+            return level;
+        }
+
+        virtual void injectHormones(int insulinUnits, int glucagonUnits)
+        {
+            *Insulin += insulinUnits;
+            *Glucagon += glucagonUnits;
+            InProcessTransport::injectHormones(insulinUnits, glucagonUnits);
+        }
+
+    private:
+        long *Readings;
+        long *InRange;
+        long *Hypo;
+        long *Hyper;
+        long *Insulin;
+        long *Glucagon;
+        bool Below;
+        bool Above;
+};
+
+
+
+/* The constructor takes the values that are not swept
+ */
+ParameterSweep::ParameterSweep(config base)
+{
+    Base = base;
+    Cycles = SWEEP_CYCLES;
+
+    for(int i = 0; i < SWEEP_PARAMETERS; i++)
+    {
+        Ranges[i].min = Ranges[i].max = 0;
+        Ranges[i].step = 1;
+    }
+}
+
+
+/* Reads the ranges and builds the grid
+ */
+bool ParameterSweep::load(QString filename)
+{
+    QFileInfo checkFile(filename);
+    if(!checkFile.exists())
+    {
+        return false;
+    }
+
+    QSettings SweepFile(filename, QSettings::NativeFormat);
+    SweepFile.beginGroup( "Sweep" );
+
+    if((Cycles = SweepFile.value("Cycles", SWEEP_CYCLES).toInt()) <= 0)
+    {
+        return false;
+    }
+    if(!readRange(SweepFile, "Sensitivity", Base.hsf, &Ranges[0]) ||
+       !readRange(SweepFile, "UpperLevel", Base.upperLevel, &Ranges[1]) ||
+       !readRange(SweepFile, "LowerLevel", Base.lowerLevel, &Ranges[2]) ||
+       !readRange(SweepFile, "UpperLimit", Base.upperLimit, &Ranges[3]) ||
+       !readRange(SweepFile, "LowerLimit", Base.lowerLimit, &Ranges[4]))
+    {
+        return false;
+    }
+    SweepFile.endGroup();
+
+    Results.clear();
+    sweepresult result = sweepresult();
+    result.cfg = Base;
+
+    for(int hsf = Ranges[0].min; hsf <= Ranges[0].max; hsf += Ranges[0].step)
+    for(int upperLevel = Ranges[1].min; upperLevel <= Ranges[1].max; upperLevel += Ranges[1].step)
+    for(int lowerLevel = Ranges[2].min; lowerLevel <= Ranges[2].max; lowerLevel += Ranges[2].step)
+    for(int upperLimit = Ranges[3].min; upperLimit <= Ranges[3].max; upperLimit += Ranges[3].step)
+    for(int lowerLimit = Ranges[4].min; lowerLimit <= Ranges[4].max; lowerLimit += Ranges[4].step)
+    {
+        if(lowerLevel >= upperLevel || lowerLimit >= upperLimit)
+        {
+            continue;
+        }
+        result.cfg.hsf = hsf;
+        result.cfg.upperLevel = upperLevel;
+        result.cfg.lowerLevel = lowerLevel;
+        result.cfg.upperLimit = upperLimit;
+        result.cfg.lowerLimit = lowerLimit;
+        Results.push_back(result);
+    }
+
+    return true;
+}
+
+/* Number of parameter sets of the grid
+ */
+int ParameterSweep::getPoints() const
+{
+    return Results.size();
+}
+
+
+/* One task per parameter set, the results do not share any memory
+ */
+void ParameterSweep::run(Tracer *tracer, int threads)
+{
+    WorkStealingPool Pool(threads);
+
+    for(size_t i = 0; i < Results.size(); i++)
+    {
+        sweepresult *result = &Results[i];
+        Pool.submit([this, tracer, result]{ simulate(tracer, result); });
+    }
+    Pool.wait();
+}
+
+/* Writes the results as CSV
+ */
+void ParameterSweep::print(ostream &out) const
+{
+    out << "hsf,upperLevel,lowerLevel,upperLimit,lowerLimit,"
+           "timeInRange,hypoEvents,hyperEvents,insulinUnits,glucagonUnits" << endl;
+
+    for(size_t i = 0; i < Results.size(); i++)
+    {
+        const sweepresult &r = Results[i];
+        out << r.cfg.hsf << "," << r.cfg.upperLevel << "," << r.cfg.lowerLevel << ","
+            << r.cfg.upperLimit << "," << r.cfg.lowerLimit << ","
+            << (r.readings > 0 ? 100.0 * r.inRange / r.readings : 0) << ","
+            << r.hypo << "," << r.hyper << "," << r.insulin << "," << r.glucagon << "\n";
+    }
+    out << flush;
+}
+
+
+/* Body factor & direction of the options 1-5 of the Body menu
+ */
+void ParameterSweep::getScenario(int scenario, float *factor, bool *rising)
+{
+    *factor = ScenarioFactor[scenario];
+    *rising = ScenarioRising[scenario];
+}
+
+
+/* Runs every scenario for one parameter set, battery & reservoirs are kept filled
+ */
+void ParameterSweep::simulate(Tracer *tracer, sweepresult *result)
+{
+    for(int scenario = 0; scenario < SWEEP_SCENARIOS; scenario++)
+    {
+        Body body(INPROCESS_BODY_BSL, INPROCESS_INSULIN_CONSTANT, INPROCESS_GLUCAGON_CONSTANT);
+        SweepTransport transport(&body, ScenarioFactor[scenario], ScenarioRising[scenario],
+                                 &result->readings, &result->inRange, &result->hypo,
+                                 &result->hyper, &result->insulin, &result->glucagon);
+        Pump ThePump(tracer, result->cfg, &transport, &transport);
+        ThePump.initPump();
+
+        for(int cycle = 0; cycle < Cycles; cycle++)
+        {
+            ThePump.changeBatteryPowerLevel(MAX_BATTERY_CHARGE);
+            ThePump.refillInsulinReservoir();
+            ThePump.refillGlucagonReservoir();
+            ThePump.runPump();
+        }
+    }
+}
+
+/* Parses "min,max,step" or a single value
+ */
+bool ParameterSweep::readRange(QSettings &file, QString key, int base, sweeprange *range)
+{
+    QStringList values = file.value(key, QString::number(base)).toStringList();
+
+    range->min = values.value(0).toInt();
+    range->max = values.size() > 1 ? values.value(1).toInt() : range->min;
+    range->step = values.size() > 2 ? values.value(2).toInt() : 1;
+
+    return range->min > 0 && range->max >= range->min && range->step > 0;
+}
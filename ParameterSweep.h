@@ -0,0 +1,154 @@
+/**
+ * @file:   ParameterSweep.h
+ * @class:  ParameterSweep
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Monte Carlo sweep over the therapy parameters
+ *          Every parameter set runs the body scenarios in parallel
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef parametersweep_
+#define parametersweep_
+
+#include <QSettings>
+#include <QString>
+#include <ostream>
+#include <vector>
+#include "Config.h"
+#include "Tracer.h"
+
+
+#define SWEEP_CYCLES        96      // pump cycles per scenario, 48 h of body time
+#define SWEEP_RANGE_LOW     70      // time in range: lower bound in mg/dL
+#define SWEEP_RANGE_HIGH    180     // time in range: upper bound in mg/dL
+#define SWEEP_PARAMETERS    5       // hsf, upper/lower level, upper/lower limit
+#define SWEEP_SCENARIOS     5       // the options 1-5 of the Body menu
+
+
+
+class ParameterSweep
+{
+    public:
+        /**
+         * @name:   Parameter Sweep
+         * @brief:  Parameter Sweep Constructor
+         *
+         * @param:  The configuration the swept parameters start from
+         */
+        ParameterSweep(config base);
+
+        /**
+         * @name:   Load
+         * @brief:  Reads the parameter ranges of a sweep file
+         *
+         *  The "Sweep" section holds "min,max,step" for Sensitivity,
+         *  UpperLevel, LowerLevel, UpperLimit and LowerLimit and the
+         *  number of Cycles. Missing parameters keep the base value.
+         *  Combinations with a lower level/limit not below the upper
+         *  one are left out.
+         *
+         * @param:  The filename of the sweep file
+         * @return: When all given ranges are valid, 'true' is returned
+         */
+        bool load(QString filename);
+
+        /**
+         * @name:   Get Points
+         * @brief:  Number of parameter sets of the grid
+         *
+         * @return: The number of parameter sets
+         */
+        int getPoints() const;
+
+        /**
+         * @name:   Run
+         * @brief:  Simulates all parameter sets on a work stealing pool
+         *
+         * @param:  The tracer shared by all pumps, must be thread safe
+         * @param:  The number of worker threads, 0 for one per core
+         */
+        void run(Tracer *tracer, int threads);
+
+        /**
+         * @name:   Print
+         * @brief:  Writes one CSV line per parameter set
+         *
+         * @param:  The stream to write to
+         */
+        void print(std::ostream &out) const;
+
+        /**
+         * @name:   Get Scenario
+         * @brief:  Body factor & direction of a scenario
+         *
+         * @param:  The scenario, 0 to SWEEP_SCENARIOS - 1
+         * @param:  Receives the factor the BSL is rising or falling per step
+         * @param:  Receives 'true' if the BSL is rising
+         */
+        static void getScenario(int scenario, float *factor, bool *rising);
+
+    private:
+        /**
+         * @name:   Sweep Range
+         * @brief:  Values min, min + step, ... up to max
+         */
+        struct sweeprange{
+            int min;
+            int max;
+            int step;
+        };
+
+        /**
+         * @name:   Sweep Result
+         * @brief:  One parameter set and what all scenarios did with it
+         *
+         *  Readings    Readings over all scenarios
+         *  InRange     Readings between SWEEP_RANGE_LOW and SWEEP_RANGE_HIGH
+         *  Hypo/Hyper  Times the BSL went below/above the range
+         *  Insulin     Units of insulin delivered
+         *  Glucagon    Units of glucagon delivered
+         */
+        struct sweepresult{
+            config cfg;
+            long readings;
+            long inRange;
+            long hypo;
+            long hyper;
+            long insulin;
+            long glucagon;
+        };
+
+        config Base;
+        int Cycles;
+        sweeprange Ranges[SWEEP_PARAMETERS];
+        std::vector<sweepresult> Results;
+
+        /**
+         * @name:   Simulate
+         * @brief:  Runs all scenarios for one parameter set
+         *
+         * @param:  The tracer for the pumps
+         * @param:  The parameter set, receives the results
+         */
+        void simulate(Tracer *tracer, sweepresult *result);
+
+        /**
+         * @name:   Read Range
+         * @brief:  Parses "min,max,step" or a single value
+         *
+         * @param:  The sweep file
+         * @param:  The key of the parameter
+         * @param:  The value if the key is missing
+         * @param:  Receives the range
+         * @return: When the range is valid, 'true' is returned
+         */
+        static bool readRange(QSettings &file, QString key, int base, sweeprange *range);
+};
+
+#endif
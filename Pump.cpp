@@ -33,7 +33,6 @@
 #include <string.h>
 #include <unistd.h>
 #include <QObject>
-#include <fstream>
 
 using namespace std;
 
@@ -43,7 +42,7 @@ using namespace std;
  *                              EXTERNAL CALLABLE FUNCTIONS                                         *
  *                                                                                                  *
  ***************************************************************************************************/
-Pump::Pump(Tracer *trcr, config cfg)
+Pump::Pump(Tracer *trcr, config cfg, SensorTransport *sensor, InjectionTransport *injection)
 {   
     this->tracer = trcr;
 
@@ -56,6 +55,15 @@ Pump::Pump(Tracer *trcr, config cfg)
     lowerAlarm = cfg.lowerAlarm;
     reservoirWarning = cfg.resWarn;
     reservoirCritical = cfg.resCrit;
+
+    sensorTransport = sensor;
+    injectionTransport = injection;
+    lostReadings = 0;
+    missedReadings = 0;
+    recorder = NULL;
+    insulinReservoirLevel = 0;
+    glucagonReservoirLevel = 0;
+    publishedStatus = -1;
 }
 
 
@@ -82,44 +90,46 @@ void Pump::initPump()
 // main for pump
 bool Pump::runPump()
 {
+    if (recorder)
+    {
+        recorder->beginCycle(batteryPowerLevel, insulinReservoirLevel, glucagonReservoirLevel);
+    }
+
     //drain power of battery
     drainBatteryPower(1);
 
-    // First iteration: no latest blood sugar value, set latest to current
-    if (currentBSLevel <= 0)
+    // No reading: the cycle is lost, logged once until the body answers again
+    int reading = readBloodSugarSensor();
+    if (reading == -1)
     {
-        currentBSLevel = readBloodSugarSensor();
-        if (currentBSLevel == -1)
+        if (missedReadings++ == 0)
         {
-            QString err = "Pump: No body found!";
+            QString err = currentBSLevel <= 0 ? "Pump: No body found!" : "Pump: No reading from body!";
             tracer->writeCriticalLog(err);
-            return false;
-        }
-        else
-        {
-            latestBSLevel = currentBSLevel;
         }
+        return false;
     }
-    // Following iterations: former blood sugar value to latest, read new one from sensor
-    else
+    if (missedReadings > 0)
     {
-        latestBSLevel = currentBSLevel;
-        currentBSLevel = readBloodSugarSensor();
+        QString msg = "Pump: Reading from body again (" + QString::number(missedReadings) + " cycles lost).";
+        tracer->writeStatusLog(msg);
+        missedReadings = 0;
     }
 
-    // low/high blood sugar level checks
-    if (currentBSLevel <= lowerAlarm)
+    // First iteration: no latest blood sugar value, set latest to current
+    if (currentBSLevel <= 0)
     {
-        QString err = "Pump: Low blood sugar level!";
-        tracer->writeCriticalLog(err);
+        latestBSLevel = reading;
     }
-    if (currentBSLevel >= upperAlarm)
+    // Following iterations: former blood sugar value to latest
+    else
     {
-        QString err = "Pump: High blood sugar level!";
-        tracer->writeCriticalLog(err);
+        latestBSLevel = currentBSLevel;
     }
+    currentBSLevel = reading;
 
     int hormonesToInject = 0; //<<---init with bogus value.
+    // low/high blood sugar level alarms: by the control system, from this signal
     emit updateBloodSugarLevel(currentBSLevel);
 
     // inject insulin
@@ -166,6 +176,13 @@ bool Pump::runPump()
 }
 
 
+// sets the trace the cycles are recorded to
+void Pump::setRecorder(TraceRecorder *rec)
+{
+    recorder = rec;
+}
+
+
 // battery recharge
 void Pump::rechargeBatteryPower(int charge)
 {
@@ -174,6 +191,7 @@ void Pump::rechargeBatteryPower(int charge)
     {
         //TODO! <- check for correctness.
         batteryPowerLevel = charge;
+        emit batteryLevelChanged(batteryPowerLevel);
     }
     else
     {
@@ -189,6 +207,21 @@ int Pump::getBatteryPowerLevel()
     return this->batteryPowerLevel;
 }
 
+int Pump::getCurrentBSLevel() const
+{
+    return this->currentBSLevel;
+}
+
+int Pump::getInsulinReservoirLevel() const
+{
+    return this->insulinReservoirLevel;
+}
+
+int Pump::getGlucagonReservoirLevel() const
+{
+    return this->glucagonReservoirLevel;
+}
+
 
 int Pump::getPumpStatus() const
 {
@@ -229,6 +262,7 @@ void Pump::drainBatteryPower(int powerdrain)
     {
         //TODO! <- check for correctness.
         batteryPowerLevel-=powerdrain;
+        emit batteryLevelChanged(batteryPowerLevel);
     }
     else
     {
@@ -240,52 +274,40 @@ void Pump::drainBatteryPower(int powerdrain)
 // read BSL value from sensor
 int Pump::readBloodSugarSensor()
 {
-    ifstream file;
-    char line[4];
-
-    file.open("pipe_to_pump", ios_base::in);
-
-    if (file.good())
+    int level = sensorTransport->readBloodSugarLevel();
+    if (recorder)
     {
-        file.seekg(0L, ios::beg);
-        file.getline(line, 4);
-        file.close();
-
-        remove("pipe_to_pump");
-
-        return atoi(line);
+        recorder->recordReading(level);
     }
-    else
+
+    uint32_t lost = sensorTransport->getLostReadings();
+    if (lost != lostReadings)
     {
-        return -1;
+        lostReadings = lost;
+        QString msg = "Pump: Sensor readings lost (" + QString::number(lost) + " total)!";
+        tracer->writeWarningLog(msg);
     }
+
+    return level;
 }
 
 
 // inject hormone to body
 void Pump::injectHormoneToBody(int amount, bool insulin)
 {
-    ofstream file("pipe_to_body", ios_base::out);
+    if (recorder)
+    {
+        recorder->recordInjection(insulin ? amount : 0, insulin ? 0 : amount);
+    }
 
     if (insulin)
     {
-        if (amount < 10)
-        {
-            file << "0";
-        }
-        file << amount;
-        file << "00";
+        injectionTransport->injectHormones(amount, 0);
     }
     else
     {
-        file << "00";
-        if (amount < 10)
-        {
-            file << "0";
-        }
-        file << amount;
+        injectionTransport->injectHormones(0, amount);
     }
-    file.close();
 }
 
 
@@ -314,6 +336,7 @@ void Pump::prepareInjection(bool insulin, int amount)
             }
             emit updateInsulinReservoir(insulinReservoirLevel);
             emit updateHormoneInjectionLog(UserInterface::INSULIN, amount);
+            publishStatus();
 /*
             if (insulinReservoirLevel <= reservoirCritical)
             {
@@ -342,17 +365,8 @@ void Pump::prepareInjection(bool insulin, int amount)
             }
             emit updateGlucagonReservoir(glucagonReservoirLevel);
             emit updateHormoneInjectionLog(UserInterface::GLUCAGON, amount);
-
-            if (glucagonReservoirLevel <= reservoirCritical)
-            {
-                msg = "Pump: Glucagon reservoir empty! Please refill!";
-                tracer->writeCriticalLog(msg);
-            }
-            else if (glucagonReservoirLevel <= reservoirWarning)
-            {
-                msg = "Pump: Glucagon reservoir nearly empty! Please refill!";
-                tracer->writeWarningLog(msg);
-            }
+            // reservoir alarms: by the control system, from pumpStatusChanged()
+            publishStatus();
         }
     }
 
@@ -372,6 +386,18 @@ int Pump::calculateNeededHormone(int targetBloodSugarLevel)
 }
 
 
+// publishes a changed pump status
+void Pump::publishStatus()
+{
+    int status = getPumpStatus();
+    if (status != publishedStatus)
+    {
+        publishedStatus = status;
+        emit pumpStatusChanged(status);
+    }
+}
+
+
 /****************************************************************************************************
  *                                                                                                  *
  *                                             SLOTS                                                *
@@ -380,9 +406,14 @@ int Pump::calculateNeededHormone(int targetBloodSugarLevel)
 // changes the batteries power level
 void Pump::changeBatteryPowerLevel(int level)
 {
+    bool changed = batteryPowerLevel != level;
     batteryPowerLevel = level;
     // Update UI
     emit updateBatteryPowerLevel(level);
+    if (changed)
+    {
+        emit batteryLevelChanged(level);
+    }
 }
 
 // refills insulin reservoir
@@ -391,6 +422,7 @@ void Pump::refillInsulinReservoir()
     insulinReservoirLevel = 100;
     // Update UI
     emit updateInsulinReservoir(100);
+    publishStatus();
 }
 
 // refills glucagon reservoir
@@ -399,6 +431,7 @@ void Pump::refillGlucagonReservoir()
     glucagonReservoirLevel = 100;
     // Update UI
     emit updateGlucagonReservoir(100);
+    publishStatus();
 }
 
 // changes insulin amount
@@ -407,6 +440,7 @@ void Pump::setInsulinAmount(int level)
     insulinReservoirLevel = level;
     // Update UI
     emit updateInsulinReservoir(level);
+    publishStatus();
 }
 
 // changes glucagon amount
@@ -415,4 +449,5 @@ void Pump::setGlucagonAmount(int level)
     glucagonReservoirLevel = level;
     // Update UI
     emit updateGlucagonReservoir(level);
+    publishStatus();
 }
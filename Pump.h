@@ -38,7 +38,9 @@
 #define MAX_BATTERY_CHARGE  100
 
 #include "Config.h"
+#include "PumpTrace.h"
 #include "Tracer.h"
+#include "Transport.h"
 #include <QObject>
 
 using namespace std;
@@ -84,6 +86,12 @@ private:
     // reservoir level critical
     int reservoirCritical;
 
+    // where the readings come from
+    SensorTransport *sensorTransport;
+
+    // where the injections go to
+    InjectionTransport *injectionTransport;
+
 
 
     /****************************************************************************************************
@@ -118,6 +126,18 @@ private:
     // current battery power level
     int batteryPowerLevel;
 
+    // readings lost by the sensor transport so far
+    uint32_t lostReadings;
+
+    // cycles without a reading in a row
+    uint32_t missedReadings;
+
+    // records the cycles if set
+    TraceRecorder *recorder;
+
+    // pump status of the last pumpStatusChanged(), -1 before the first
+    int publishedStatus;
+
 
 
     /****************************************************************************************************
@@ -152,7 +172,7 @@ private:
 
     /**
      * @brief   Pump::readBloodSugarSensor
-     *          Reads the current blood sugar level via pipe from body.
+     *          Reads the current blood sugar level via the sensor transport.
      *
      * @return  the current blood sugar level.
      */
@@ -160,7 +180,7 @@ private:
 
     /**
      * @brief   Pump::injectHormoneToBody
-     *          Injects the calculated amount of hormones to the body via pipe.
+     *          Injects the calculated amount of hormones to the body via the injection transport.
      *
      * @param   amount
      *          the amount of hormones to inject.
@@ -184,6 +204,13 @@ private:
      */
     int calculateNeededHormone(int targetBloodSugarLevel);
 
+    /**
+     * @brief publishStatus
+     *        Emits pumpStatusChanged() if the pump status differs from the
+     *        last published one, called after every reservoir change.
+     */
+    void publishStatus();
+
 
 
 
@@ -203,8 +230,12 @@ public:
       *        error handling obj
       * @param cfg
       *        struct for .conf
+      * @param sensor
+      *        transport the readings come from
+      * @param injection
+      *        transport the injections go to
       */
-     Pump(Tracer *tracer, config cfg);
+     Pump(Tracer *tracer, config cfg, SensorTransport *sensor, InjectionTransport *injection);
 
     /* DTOR
      *
@@ -224,6 +255,15 @@ public:
      */
     bool runPump();
 
+    /**
+     * @brief setRecorder
+     *        records readings, injections and battery/reservoir changes of every cycle.
+     *
+     * @param recorder
+     *        the trace to record to, NULL stops recording.
+     */
+    void setRecorder(TraceRecorder *recorder);
+
     /**
      * @brief rechargeBatteryPower
      *        recharges battery up to 100% of charge.
@@ -245,6 +285,15 @@ public:
      /** @return battery power level.*/
      int getBatteryPowerLevel();
 
+     /** @return blood sugar level of the last cycle.*/
+     int getCurrentBSLevel() const;
+
+     /** @return fill level of the insulin reservoir.*/
+     int getInsulinReservoirLevel() const;
+
+     /** @return fill level of the glucagon reservoir.*/
+     int getGlucagonReservoirLevel() const;
+
 
 public slots:
      /****************************************************************************************************
@@ -321,6 +370,27 @@ signals:
      *        units of injected hormone.
      */
     void updateHormoneInjectionLog(int hormone, int injectHormUnits);
+
+    /**
+     * @brief batteryLevelChanged
+     *        Event for the health monitoring, only emitted when the level
+     *        changed, on the thread that changed it.
+     *
+     * @param level
+     *        The new level of battery power.
+     */
+    void batteryLevelChanged(int level);
+
+    /**
+     * @brief pumpStatusChanged
+     *        Event for the health monitoring, emitted when a reservoir
+     *        crossed its warning or critical level, on the thread that
+     *        changed it.
+     *
+     * @param status
+     *        The new pump status, see getPumpStatus().
+     */
+    void pumpStatusChanged(int status);
 }; //END HEADER
 
 #endif
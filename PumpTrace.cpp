@@ -0,0 +1,233 @@
+/**
+ * @file:   PumpTrace.cpp
+ * @class:  TraceRecorder, TraceReplay
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Binary trace of the pump cycles
+ *          Recording while running, replay without a body
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "PumpTrace.h"
+#include <string.h>
+
+using namespace std;
+
+
+
+/* The constructor creates the trace file and writes the header
+ */
+TraceRecorder::TraceRecorder(const char *filename)
+{
+    Cycle = 0;
+    Battery = -1;
+    InsulinReservoir = -1;
+    GlucagonReservoir = -1;
+
+    File = fopen(filename, "wb");
+    if(File)
+    {
+        write(TRACE_HEADER, TRACE_MAGIC, TRACE_VERSION);
+    }
+}
+
+/* The destructor flushes and closes the trace file
+ */
+TraceRecorder::~TraceRecorder()
+{
+    if(File)
+    {
+        fclose(File);
+    }
+}
+
+
+/* Checks if the trace file could be created
+ */
+bool TraceRecorder::isValid() const
+{
+    return File != NULL;
+}
+
+/* Starts the next cycle, only changed levels are recorded
+ */
+void TraceRecorder::beginCycle(int battery, int insulinReservoir, int glucagonReservoir)
+{
+    Cycle++;
+
+    if(battery != Battery)
+    {
+        Battery = battery;
+        write(TRACE_BATTERY, battery, 0);
+    }
+    if(insulinReservoir != InsulinReservoir || glucagonReservoir != GlucagonReservoir)
+    {
+        InsulinReservoir = insulinReservoir;
+        GlucagonReservoir = glucagonReservoir;
+        write(TRACE_RESERVOIR, insulinReservoir, glucagonReservoir);
+    }
+}
+
+/* Records a sensor reading & an injection of the current cycle
+ */
+void TraceRecorder::recordReading(int level)
+{
+    write(TRACE_READING, level, 0);
+}
+
+void TraceRecorder::recordInjection(int insulinUnits, int glucagonUnits)
+{
+    write(TRACE_INJECTION, insulinUnits, glucagonUnits);
+}
+
+/* Getter for the number of recorded cycles
+ */
+uint32_t TraceRecorder::getCycles() const
+{
+    return Cycle;
+}
+
+/* Appends one record, stdio buffers the writes
+ */
+void TraceRecorder::write(uint8_t type, int32_t value, int32_t value2)
+{
+    tracerecord record;
+
+    if(!File)
+    {
+        return;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.type = type;
+    record.cycle = Cycle;
+    record.value = value;
+    record.value2 = value2;
+    fwrite(&record, sizeof(record), 1, File);
+}
+
+
+
+/* The constructor loads the whole trace
+ */
+TraceReplay::TraceReplay(const char *filename)
+{
+    tracerecord record;
+
+    Position = 1;
+    Cycle = 0;
+    Mismatches = 0;
+    Valid = false;
+
+    FILE *file = fopen(filename, "rb");
+    if(!file)
+    {
+        return;
+    }
+    while(fread(&record, sizeof(record), 1, file) == 1)
+    {
+        Records.push_back(record);
+    }
+    fclose(file);
+
+    Valid = !Records.empty() && Records[0].type == TRACE_HEADER &&
+            Records[0].value == (int32_t)TRACE_MAGIC && Records[0].value2 == TRACE_VERSION;
+}
+
+
+/* Checks if the trace could be loaded
+ */
+bool TraceReplay::isValid() const
+{
+    return Valid;
+}
+
+/* Skips what is left of the last cycle and returns the levels of the next one
+ */
+bool TraceReplay::nextCycle(tracestate *state)
+{
+    const tracerecord *record;
+
+    while(Position < Records.size() && Records[Position].cycle <= Cycle)
+    {
+        Mismatches++;
+        Position++;
+    }
+    if(!Valid || Position >= Records.size())
+    {
+        return false;
+    }
+
+    Cycle = Records[Position].cycle;
+    state->battery = -1;
+    state->insulinReservoir = -1;
+    state->glucagonReservoir = -1;
+
+    if((record = take(TRACE_BATTERY)) != NULL)
+    {
+        state->battery = record->value;
+    }
+    if((record = take(TRACE_RESERVOIR)) != NULL)
+    {
+        state->insulinReservoir = record->value;
+        state->glucagonReservoir = record->value2;
+    }
+
+    return true;
+}
+
+/* The recorded reading of the current cycle
+ */
+int TraceReplay::readBloodSugarLevel()
+{
+    const tracerecord *record = take(TRACE_READING);
+    if(record == NULL)
+    {
+        Mismatches++;
+        return -1;
+    }
+
+    return record->value;
+}
+
+/* Compares the injection with the recorded one
+ */
+void TraceReplay::injectHormones(int insulinUnits, int glucagonUnits)
+{
+    const tracerecord *record = take(TRACE_INJECTION);
+    if(record == NULL || record->value != insulinUnits || record->value2 != glucagonUnits)
+    {
+        Mismatches++;
+    }
+}
+
+
+/* Getter for the replayed cycles & mismatches
+ */
+uint32_t TraceReplay::getCycles() const
+{
+    return Cycle;
+}
+
+uint32_t TraceReplay::getMismatches() const
+{
+    return Mismatches;
+}
+
+/* Takes the next record if it is of the type and current cycle
+ */
+const tracerecord *TraceReplay::take(uint8_t type)
+{
+    if(Position < Records.size() && Records[Position].cycle == Cycle &&
+       Records[Position].type == type)
+    {
+        return &Records[Position++];
+    }
+
+    return NULL;
+}
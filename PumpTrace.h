@@ -0,0 +1,231 @@
+/**
+ * @file:   PumpTrace.h
+ * @class:  TraceRecorder, TraceReplay
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Binary trace of the pump cycles
+ *          Recording while running, replay without a body
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef pumptrace_
+#define pumptrace_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include "Transport.h"
+
+
+#define TRACE_FILE_NAME     "InsulinPump.trace"
+
+#define TRACE_MAGIC         0x43525450  // "PTRC"
+#define TRACE_VERSION       1
+
+#define TRACE_HEADER        0   // value = TRACE_MAGIC, value2 = TRACE_VERSION
+#define TRACE_READING       1   // value = sensor reading in mg/dL, -1 if there was none
+#define TRACE_INJECTION     2   // value = insulin units, value2 = glucagon units
+#define TRACE_BATTERY       3   // value = battery level at the start of the cycle
+#define TRACE_RESERVOIR     4   // value = insulin, value2 = glucagon level at the start of the cycle
+
+
+/**
+ * @name        Trace Record
+ * @brief       One event of a pump cycle, in host byte order
+ *
+ *  Type        TRACE_*
+ *  Cycle       Number of the pump cycle, starting at 1 (0 for the header)
+ *  Value       See TRACE_*
+ *  Value2      See TRACE_*
+ */
+struct tracerecord{
+    uint8_t  type;
+    uint8_t  reserved[3];
+    uint32_t cycle;
+    int32_t  value;
+    int32_t  value2;
+};
+
+static_assert(sizeof(tracerecord) == 16, "tracerecord must stay 16 bytes");
+
+
+/**
+ * @name        Trace State
+ * @brief       Battery & reservoir levels a replayed cycle starts with
+ *
+ *  The levels are -1 when the cycle did not change them
+ */
+struct tracestate{
+    int battery;
+    int insulinReservoir;
+    int glucagonReservoir;
+};
+
+
+
+class TraceRecorder
+{
+    public:
+        /**
+         * @name:   Trace Recorder
+         * @brief:  Trace Recorder Constructor
+         *
+         *  Creates the trace file and writes the header
+         *
+         * @param:  The filename of the trace
+         */
+        TraceRecorder(const char *filename);
+
+        /**
+         * @name:   ~Trace Recorder
+         * @brief:  Trace Recorder Destructor
+         *
+         *  Flushes and closes the trace file
+         */
+        ~TraceRecorder();
+
+        /**
+         * @name:   Is Valid
+         * @brief:  Checks if the trace file could be created
+         *
+         * @return: When the trace is written, 'true' is returned
+         */
+        bool isValid() const;
+
+        /**
+         * @name:   Begin Cycle
+         * @brief:  Starts the next cycle, records changed levels
+         *
+         *  Battery and reservoirs are only recorded when they differ
+         *  from the levels recorded last
+         *
+         * @param:  The battery level
+         * @param:  The insulin reservoir level
+         * @param:  The glucagon reservoir level
+         */
+        void beginCycle(int battery, int insulinReservoir, int glucagonReservoir);
+
+        /**
+         * @name:   Record Reading
+         * @brief:  Records a sensor reading of the current cycle
+         *
+         * @param:  The reading in mg/dL, -1 if there was none
+         */
+        void recordReading(int level);
+
+        /**
+         * @name:   Record Injection
+         * @brief:  Records the units handed to the body in the current cycle
+         *
+         * @param:  Units of insulin
+         * @param:  Units of glucagon
+         */
+        void recordInjection(int insulinUnits, int glucagonUnits);
+
+        /**
+         * @name:   Get Cycles
+         * @brief:  Number of recorded cycles
+         *
+         * @return: The number of cycles
+         */
+        uint32_t getCycles() const;
+
+    private:
+        FILE *File;
+        uint32_t Cycle;
+
+        /**
+         * @name:   Battery & Reservoirs
+         * @brief:  The levels recorded last, -1 before the first cycle
+         */
+        int Battery;
+        int InsulinReservoir;
+        int GlucagonReservoir;
+
+        void write(uint8_t type, int32_t value, int32_t value2);
+};
+
+
+
+class TraceReplay : public SensorTransport, public InjectionTransport
+{
+    public:
+        /**
+         * @name:   Trace Replay
+         * @brief:  Trace Replay Constructor
+         *
+         *  Loads the whole trace into memory
+         *
+         * @param:  The filename of the trace
+         */
+        TraceReplay(const char *filename);
+
+        /**
+         * @name:   Is Valid
+         * @brief:  Checks if the trace could be loaded
+         *
+         * @return: When the trace has a valid header, 'true' is returned
+         */
+        bool isValid() const;
+
+        /**
+         * @name:   Next Cycle
+         * @brief:  Moves on to the next recorded cycle
+         *
+         *  Records the pump did not ask for in the last cycle count
+         *  as mismatches
+         *
+         * @param:  Receives the levels the cycle starts with
+         * @return: When there is another cycle, 'true' is returned
+         */
+        bool nextCycle(tracestate *state);
+
+        /**
+         * @name:   Read Blood Sugar Level
+         * @brief:  The recorded reading of the current cycle
+         *
+         * @return: The reading in mg/dL, -1 if none was recorded
+         */
+        virtual int readBloodSugarLevel();
+
+        /**
+         * @name:   Inject Hormones
+         * @brief:  Compares the injection with the recorded one
+         *
+         * @param:  Units of insulin
+         * @param:  Units of glucagon
+         */
+        virtual void injectHormones(int insulinUnits, int glucagonUnits);
+
+        /**
+         * @name:   Get Cycles/Mismatches
+         * @brief:  Replayed cycles & events that differ from the recording
+         *
+         * @return: The number of cycles/mismatches
+         */
+        uint32_t getCycles() const;
+        uint32_t getMismatches() const;
+
+    private:
+        std::vector<tracerecord> Records;
+        size_t Position;
+        uint32_t Cycle;
+        uint32_t Mismatches;
+        bool Valid;
+
+        /**
+         * @name:   Take
+         * @brief:  Takes the next record if it is of the type and current cycle
+         *
+         * @param:  The expected TRACE_* type
+         * @return: The record, NULL if the next one is something else
+         */
+        const tracerecord *take(uint8_t type);
+};
+
+#endif
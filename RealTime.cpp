@@ -0,0 +1,70 @@
+/**
+ * @file:   RealTime.cpp
+ * @class:  RealTime
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Real-time settings of the control threads
+ *          SCHED_FIFO priority, CPU affinity & locked memory
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "RealTime.h"
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+using namespace std;
+
+
+
+/* SCHED_FIFO for the calling thread
+ */
+bool RealTime::setPriority(int priority)
+{
+    if(priority <= 0)
+    {
+        return true;
+    }
+
+    struct sched_param param = {};
+    param.sched_priority = priority > REALTIME_PRIORITY_MAX ? REALTIME_PRIORITY_MAX : priority;
+
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+/* One CPU for the calling thread
+ */
+bool RealTime::setAffinity(int cpu)
+{
+    if(cpu < 0)
+    {
+        return true;
+    }
+    if(cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/* All pages of the process, also the ones allocated later
+ */
+bool RealTime::lockMemory(bool lock)
+{
+    if(lock)
+    {
+        return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+    }
+
+    return munlockall() == 0;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file:   RealTime.h
+ * @class:  RealTime
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Real-time settings of the control threads
+ *          SCHED_FIFO priority, CPU affinity & locked memory
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef realtime_
+#define realtime_
+
+
+#define REALTIME_PRIORITY_MAX   99      // highest SCHED_FIFO priority on Linux
+
+
+
+class RealTime
+{
+    public:
+        /**
+         * @name:   Set Priority
+         * @brief:  Moves the calling thread to SCHED_FIFO
+         *
+         *  Needs CAP_SYS_NICE or an RLIMIT_RTPRIO of at least the priority,
+         *  the thread keeps its policy if not permitted
+         *
+         * @param:  The priority 1..99, 0 leaves the thread alone
+         * @return: When the priority is set or not wanted, 'true' is returned
+         */
+        static bool setPriority(int priority);
+
+        /**
+         * @name:   Set Affinity
+         * @brief:  Pins the calling thread to one CPU
+         *
+         * @param:  The number of the CPU, -1 leaves the thread alone
+         * @return: When the thread is pinned or not wanted, 'true' is returned
+         */
+        static bool setAffinity(int cpu);
+
+        /**
+         * @name:   Lock Memory
+         * @brief:  Locks all pages of the process into RAM, now & later
+         *
+         *  No page faults to disk on the dosing path. Needs CAP_IPC_LOCK
+         *  or an RLIMIT_MEMLOCK above the size of the process.
+         *
+         * @param:  'true' to lock, 'false' to unlock
+         * @return: When the memory is (un)locked, 'true' is returned
+         */
+        static bool lockMemory(bool lock);
+};
+
+#endif
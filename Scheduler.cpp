@@ -15,33 +15,98 @@
 
 
 #include "Scheduler.h"
+#include <time.h>
 
 using namespace std;
 
 
 
 /* The constructor initializes the time measurement
+ * and registers the pump cycle & the persistence jobs
  */
-Scheduler::Scheduler(Pump *ThePump, config cfg)
+Scheduler::Scheduler(Pump *ThePump, config cfg, Clock *clock) :
+    TheClock(clock ? clock : Clock::getRealClock()),
+    Executor(TheClock),
+    Adaptive(cfg)
 {
-    SchouldRun = true;
-    IntervalSec = cfg.schedInt;
     TotalOperationTime = 0;
     ConfigFileName = CONFIGFILE_NAME;
 
     this->ThePump = ThePump;
+    AdaptiveSched = cfg.adaptive;
+    Executor.setTickless(cfg.tickless != 0);
+
+    // the thread of the pump cycle sets its own priority & CPU, the
+    // persistence & the health checks keep the default policy, a failure
+    // is only reported
+    CpuAffinity = cfg.cpuAffinity;
+    RtPriority = cfg.rtPriority;
+    LockMemory = cfg.lockMemory != 0;
+    AffinityFailed = false;
+    PriorityFailed = false;
+    MemoryLocked = false;
+    Executor.setThreadInit([this](int job)
+                           {
+                               if(job != PumpJob)
+                               {
+                                   return;
+                               }
+                               if(!RealTime::setAffinity(CpuAffinity))
+                               {
+                                   AffinityFailed = true;
+                               }
+                               if(!RealTime::setPriority(RtPriority))
+                               {
+                                   PriorityFailed = true;
+                               }
+                           });
 
     SaveFile = new QSettings(ConfigFileName, QSettings::NativeFormat);
+    Journal = new OperationTimeJournal(JOURNAL_FILE_NAME);
     readOperationTime();
 
     startOperationTimeCounter();
+
+    IdleWakeups = 0;
+    getIdleStatistics(NULL, NULL);
+
+    // dosing must not wait for anything else, on a thread of its own
+    PumpJob = Executor.addJob("pump", [this]()
+                              {
+                                  if(getBatstatus() > 1)
+                                  {
+                                      triggerPump();
+                                      if(AdaptiveSched)
+                                      {
+                                          adaptInterval();
+                                      }
+                                  }
+                              },
+                              cfg.schedIntMs, SCHEDULER_PRIORITY_PUMP, 0);
+    Executor.setDedicated(PumpJob);
+    Executor.addJob("persistence", [this]() { saveOperationTime(); },
+                    SCHEDULER_PERSIST_MS, SCHEDULER_PRIORITY_SERVICE, 0);
+    Executor.setMissHandler([this](int job)
+                            {
+                                if(job == PumpJob)
+                                {
+                                    emit deadlineMissed();
+                                }
+                            });
 }
 
-/* The destructor stops the time measurement
+/* The destructor stops the jobs & the time measurement
  */
 Scheduler::~Scheduler()
 {
+    Executor.stop();
     stopOperationTimeCounter();
+    delete Journal;
+
+    if(MemoryLocked)
+    {
+        RealTime::lockMemory(false);
+    }
 }
 
 
@@ -49,20 +114,21 @@ Scheduler::~Scheduler()
  */
 int Scheduler::getStatus()
 {
-    if(!Timer.isValid())
+    if(!TimerValid)
     {
         return 1;
     }
-    else if(Thread)
+    else if(!Executor.isRunning())
     {
-        if(!Thread->joinable())
-        {
-            return 3;
-        }
+        return 2;
     }
-    else
+    else if(!TheClock->isSimulated() && Executor.getThreadCount() < SCHEDULER_THREADS)
     {
-        return 2;
+        return 3;
+    }
+    else if(Executor.isOverdue(PumpJob, SCHEDULER_STALL_PERIODS))
+    {
+        return 4;
     }
 
     return 0;
@@ -72,17 +138,28 @@ int Scheduler::getStatus()
  */
 quint64 Scheduler::getOperationTime()
 {
-    TotalOperationTime += Timer.restart();
+    chrono::steady_clock::time_point now = TheClock->now();
+    quint64 total;
+    {
+        lock_guard<mutex> lock(OperationTimeLock);
+        if(TimerValid)
+        {
+            TotalOperationTime += chrono::duration_cast<chrono::milliseconds>(now - TimerStart).count();
+            TimerStart = now;
+        }
+        total = TotalOperationTime;
+    }
 
-    emit updateOperationTime(TotalOperationTime/3600000);
+    emit updateOperationTime(total/3600000);
 
-    return TotalOperationTime;
+    return total;
 }
 
 /* Set the total operation time in milliseconds
  */
 void Scheduler::setOperationTime(quint64 milliseconds)
 {
+    lock_guard<mutex> lock(OperationTimeLock);
     TotalOperationTime = milliseconds;
 }
 
@@ -126,7 +203,9 @@ bool Scheduler::saveOperationTime()
  */
 bool Scheduler::startOperationTimeCounter()
 {
-    Timer.start();
+    lock_guard<mutex> lock(OperationTimeLock);
+    TimerStart = TheClock->now();
+    TimerValid = true;
 
     return true;
 }
@@ -135,27 +214,60 @@ bool Scheduler::startOperationTimeCounter()
  */
 bool Scheduler::stopOperationTimeCounter()
 {
-    Timer.invalidate();
+    lock_guard<mutex> lock(OperationTimeLock);
+    TimerValid = false;
 
     return true;
 }
 
-/* Reads the total operation time from the config file
+/* Reads the total operation time from the journal,
+ * the config file only before there is one
  */
 void Scheduler::readOperationTime()
 {
+    if(Journal->isValid() && Journal->hasValue())
+    {
+        TotalOperationTime = Journal->getMilliseconds();
+        return;
+    }
+
     SaveFile->beginGroup( "InsulinPump-Dynamic" );
     TotalOperationTime = SaveFile->value("TotalOperationTime").toLongLong();
     SaveFile->endGroup();
     SaveFile->sync();
+
+    if(Journal->isValid())
+    {
+        Journal->update(TotalOperationTime);
+        Journal->commit();
+    }
 }
 
-/* Writes the total operation time to the config file
+/* Writes the total operation time to the journal,
+ * the config file only if the journal can not be used
  */
 void Scheduler::writeOperationTime()
 {
+    if(TheClock->isSimulated())
+    {
+        return;
+    }
+
+    // the journal may sync to disk, not while holding the lock
+    quint64 total;
+    {
+        lock_guard<mutex> lock(OperationTimeLock);
+        total = TotalOperationTime;
+    }
+
+    if(Journal->isValid())
+    {
+        Journal->update(total);
+        return;
+    }
+
     SaveFile->beginGroup( "InsulinPump-Dynamic" );
-    SaveFile->setValue("TotalOperationTime", TotalOperationTime);
+    SaveFile->setValue("TotalOperationTime", total);
     SaveFile->endGroup();
     SaveFile->sync();
 }
@@ -173,51 +285,215 @@ void Scheduler::setConfigFileName(QString value)
     ConfigFileName = value;
 }
 
-/* Getter & Setter for Flag that thread should run periodically
+/* Getter & Setter for Flag that the jobs should run periodically
  */
-bool Scheduler::getSchouldRun() const
+bool Scheduler::getSchouldRun()
 {
-    return SchouldRun;
+    return Executor.isRunning();
 }
 
 void Scheduler::setSchouldRun(bool value)
 {
-    SchouldRun = value;
+    if(value)
+    {
+        start();
+    }
+    else
+    {
+        Executor.stop();
+    }
+}
+
+/* Starts the threads of the executor
+ */
+void Scheduler::start()
+{
+    // before the threads, so their stacks are locked as well
+    if(LockMemory && !MemoryLocked && !TheClock->isSimulated())
+    {
+        MemoryLocked = RealTime::lockMemory(true);
+    }
+
+    Executor.start(SCHEDULER_THREADS);
 }
 
-/* Getter & Setter for the thread object of the schedulling thread
+/* Getter for the real-time settings that failed
  */
-std::thread* Scheduler::getThread() const
+QString Scheduler::getRealTimeProblems()
 {
-    return Thread;
+    QStringList problems;
+
+    if(AffinityFailed)
+    {
+        problems << QString("CPU %1 not available").arg(CpuAffinity);
+    }
+    if(PriorityFailed)
+    {
+        problems << QString("SCHED_FIFO priority %1 not permitted").arg(RtPriority);
+    }
+    if(LockMemory && !MemoryLocked && !TheClock->isSimulated())
+    {
+        problems << "memory not locked";
+    }
+
+    return problems.join(", ");
 }
 
-void Scheduler::setThread(std::thread* value)
+/* Runs the jobs in simulated time on this thread
+ */
+void Scheduler::simulate(quint64 milliseconds)
 {
-    Thread = value;
+    Executor.simulate(TheClock->now() + chrono::milliseconds(milliseconds));
 }
 
-/* Getter & Setter for the treads cycle interval time
+/* Registers a job with the executor
  */
-int Scheduler::getIntervalSec() const
+int Scheduler::addJob(string name, function<void()> job, int periodMs,
+                      int priority, int deadlineMs)
 {
-    return IntervalSec;
+    return Executor.addJob(name, job, periodMs, priority, deadlineMs);
+}
+
+void Scheduler::setJobPeriod(int job, int periodMs)
+{
+    Executor.setPeriod(job, periodMs);
+}
+
+void Scheduler::triggerJob(int job)
+{
+    Executor.trigger(job);
+}
+
+/* Getter & Setter for the pump cycle interval time
+ */
+int Scheduler::getIntervalSec()
+{
+    return Executor.getPeriod(PumpJob) / 1000;
 }
 
 /* (SLOT) */
 void Scheduler::setIntervalSec(int seconds)
 {
-    IntervalSec = seconds;
+    Adaptive.setBase(seconds * 1000);
+    Executor.setPeriod(PumpJob, seconds * 1000);
 
     emit updateSchedulerThreadInterval(seconds);
 }
 
+int Scheduler::getIntervalMs()
+{
+    return Executor.getPeriod(PumpJob);
+}
+
+void Scheduler::setIntervalMs(int milliseconds)
+{
+    Adaptive.setBase(milliseconds);
+    Executor.setPeriod(PumpJob, milliseconds);
+
+    emit updateSchedulerThreadInterval(milliseconds / 1000);
+}
+
+/* Getter for the adaptive cycle time
+ */
+bool Scheduler::isAdaptive() const
+{
+    return AdaptiveSched;
+}
+
+/* Next cycle time from the readings & the battery
+ */
+void Scheduler::adaptInterval()
+{
+    int interval = Executor.getPeriod(PumpJob);
+    int next = Adaptive.next(ThePump->getCurrentBSLevel(), interval, getBatstatus());
+    if(next != interval)
+    {
+        Executor.setPeriod(PumpJob, next);
+    }
+}
+
+/* Getter for the pump cycle counters
+ */
+quint64 Scheduler::getCycles()
+{
+    return Executor.getRuns(PumpJob);
+}
+
+quint64 Scheduler::getMissedDeadlines()
+{
+    return Executor.getMissedDeadlines(PumpJob);
+}
+
+/* Getter for the histograms of the pump cycle & of all jobs
+ */
+void Scheduler::getCycleStatistics(histogramsummary *lateness, histogramsummary *execution)
+{
+    Executor.getLateness(PumpJob, lateness);
+    Executor.getExecution(PumpJob, execution);
+}
+
+QStringList Scheduler::getStatistics()
+{
+    QStringList lines;
+
+    for(int i = 0; i < Executor.getJobCount(); i++)
+    {
+        histogramsummary lateness, execution;
+        Executor.getLateness(i, &lateness);
+        Executor.getExecution(i, &execution);
+
+        lines << QString("%1: %2 runs, %3 missed, late p50/p99/p999/max %4/%5/%6/%7 us, "
+                         "exec p50/p99/p999/max %8/%9/%10/%11 us")
+                 .arg(QString::fromStdString(Executor.getName(i)))
+                 .arg(execution.count).arg(Executor.getMissedDeadlines(i))
+                 .arg(lateness.p50).arg(lateness.p99).arg(lateness.p999).arg(lateness.max)
+                 .arg(execution.p50).arg(execution.p99).arg(execution.p999).arg(execution.max);
+    }
+
+    return lines;
+}
+
+/* Getter for the wake-ups & the CPU use since the last call
+ */
+void Scheduler::getIdleStatistics(double *wakeupsPerMin, double *cpuPercent)
+{
+    struct timespec cputime;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cputime);
+    double cpu = cputime.tv_sec + cputime.tv_nsec / 1e9;
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    uint64_t wakeups = Executor.getWakeups();
+
+    double seconds = chrono::duration<double>(now - IdleSince).count();
+    if(wakeupsPerMin)
+    {
+        *wakeupsPerMin = seconds > 0 ? (wakeups - IdleWakeups) * 60 / seconds : 0;
+    }
+    if(cpuPercent)
+    {
+        *cpuPercent = seconds > 0 ? (cpu - IdleCpu) * 100 / seconds : 0;
+    }
+
+    IdleSince = now;
+    IdleCpu = cpu;
+    IdleWakeups = wakeups;
+}
+
+/* Getter for the timer loop of the executor
+ */
+bool Scheduler::isTickless()
+{
+    return Executor.isTickless();
+}
+
 
 /* Slots
  */
 void Scheduler::setOperationTimeInHours(int hours)
 {
-    TotalOperationTime = hours*3600000;
+    {
+        lock_guard<mutex> lock(OperationTimeLock);
+        TotalOperationTime = (quint64)hours*3600000;
+    }
 
     emit updateOperationTime(hours);
 }
@@ -17,16 +17,31 @@
 #ifndef scheduler_
 #define scheduler_
 
-#include <QElapsedTimer>
 #include <QSettings>
-#include <thread>
-#include <unistd.h>
+#include <QStringList>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include "AdaptiveInterval.h"
+#include "Clock.h"
 #include "Config.h"
+#include "JobExecutor.h"
+#include "OperationTimeJournal.h"
 #include "Pump.h"
+#include "RealTime.h"
 
 
 #define CONFIGFILE_NAME "InsulinPump.conf"
 
+#define SCHEDULER_THREADS           2       // shared executor threads, the pump has its own
+#define SCHEDULER_PRIORITY_PUMP     2       // dosing first
+#define SCHEDULER_PRIORITY_SERVICE  1       // persistence & health checks
+#define SCHEDULER_PERSIST_MS        JOURNAL_COMMIT_MS   // operation time handed to the journal
+#define SCHEDULER_DIAGNOSTICS_MS    5000    // histograms shown in the UI
+#define SCHEDULER_STATISTICS_MS     600000  // histograms of the pump cycle written to the log
+#define SCHEDULER_STALL_PERIODS     3       // pump cycle stalled: not done 3 periods after its release
+
 
 
 class Scheduler : public QObject
@@ -43,14 +58,17 @@ class Scheduler : public QObject
          *  connects to the insulin pump
          *
          * @param:  A pointer to the insulin pump
+         * @param:  The configuration
+         * @param:  The clock of the jobs & the operation time, NULL for the real clock
          */
-        Scheduler(Pump *ThePump, config cfg);
+        Scheduler(Pump *ThePump, config cfg, Clock *clock = NULL);
 
         /**
          * @name:   ~Scheduler
          * @brief:  Scheduler Destructor
          *
-         *  The destructor stops the time measurement
+         *  The destructor stops the jobs & the time measurement
+         *  and commits the operation time
          */
         ~Scheduler();
 
@@ -63,8 +81,9 @@ class Scheduler : public QObject
          *
          * @return: When everything is working fine, 0 is returned
          *          When the timer is not valid, 1 is returned
-         *          When the thread is not valid, 2 is returned
-         *          When the thread is not joinable, 3 is returned
+         *          When the executor is not running, 2 is returned
+         *          When the executor lost threads (real clock), 3 is returned
+         *          When the pump cycle is stalled, 4 is returned
          */
         virtual int getStatus();
 
@@ -104,7 +123,8 @@ class Scheduler : public QObject
          * @brief:  Save the systems total operation time in milliseconds
          *
          *  The scheduler is keeping track of the total operation time
-         *  by adding the actual operation time to the last total
+         *  by adding the actual operation time to the last total.
+         *  Cheap enough for every cycle, the journal commits in groups.
          *
          * @return: When saving the time is finished, 'true' is returned
          */
@@ -122,41 +142,192 @@ class Scheduler : public QObject
 
         /**
          * @name:   Get/Set Should Run
-         * @brief:  Get/Set the flag that the thread should run periodically
+         * @brief:  Get/Set the flag that the jobs should run periodically
+         *
+         *  'true' starts the executor, 'false' wakes and joins its threads
          *
-         * @param:  The flag that the thread should run periodically
-         * @return: The flag that the thread should run periodically
+         * @param:  The flag that the jobs should run periodically
+         * @return: The flag that the jobs should run periodically
          */
-        virtual bool getSchouldRun() const;
+        virtual bool getSchouldRun();
         virtual void setSchouldRun(bool value);
 
+        /**
+         * @name:   Start
+         * @brief:  Starts the executor with SCHEDULER_THREADS shared threads
+         *          and the thread of the pump cycle
+         *
+         *  The pump cycle and the persistence of the operation time are
+         *  registered by the constructor, further jobs (health checks)
+         *  may be added before or after. Locks the memory and gives the
+         *  thread of the pump cycle the priority & the CPU of the
+         *  configuration, where permitted.
+         */
+        virtual void start();
+
+        /**
+         * @name:   Get Real Time Problems
+         * @brief:  The real-time settings that could not be applied
+         *
+         * @return: The failed settings separated by commas, empty if none
+         */
+        virtual QString getRealTimeProblems();
+
+        /**
+         * @name:   Add Job
+         * @brief:  Registers a periodic job with the executor
+         *
+         *  The jobs share the threads of the executor, the pump cycle
+         *  runs on a thread of its own, so they can not delay it
+         *
+         * @param:  The name of the job
+         * @param:  The job
+         * @param:  The period in milliseconds
+         * @param:  The priority, higher runs first
+         * @param:  The deadline in milliseconds after the release, 0 for the period
+         * @return: The number of the job
+         */
+        virtual int addJob(std::string name, std::function<void()> job, int periodMs,
+                           int priority, int deadlineMs);
+
+        /**
+         * @name:   Set Job Period
+         * @brief:  Sets the period of a job, effective at once
+         *
+         * @param:  The number of the job
+         * @param:  The period in milliseconds
+         */
+        virtual void setJobPeriod(int job, int periodMs);
+
+        /**
+         * @name:   Trigger Job
+         * @brief:  Runs a job now, for events
+         *
+         *  Safe to call from any thread, also from within a job
+         *
+         * @param:  The number of the job
+         */
+        virtual void triggerJob(int job);
+
         /**
          * @name:   Get Interval Seconds
-         * @brief:  Get the threads cycle time in seconds
+         * @brief:  Get the pump cycle time in seconds
+         *
+         * @return: The pump cycle time in whole seconds
+         */
+        virtual int getIntervalSec();
+
+        /**
+         * @name:   Get/Set Interval Milliseconds
+         * @brief:  Get/Set the pump cycle time in milliseconds
+         *
+         *  A new cycle time takes effect at once, the next cycle is
+         *  released at the start of the last one plus the new time
+         *
+         * @param:  The pump cycle time in milliseconds
+         * @return: The pump cycle time in milliseconds
+         */
+        virtual int getIntervalMs();
+        virtual void setIntervalMs(int milliseconds);
+
+        /**
+         * @name:   Is Adaptive
+         * @brief:  Checks if the pump cycle time adapts itself
+         *
+         *  With AdaptiveSched the cycle time is set after every cycle,
+         *  a cycle time set from outside becomes the new base
+         *
+         * @return: When the cycle time adapts, 'true' is returned
+         */
+        virtual bool isAdaptive() const;
+
+        /**
+         * @name:   Simulate
+         * @brief:  Runs the jobs for a span of simulated time
+         *
+         *  Only with a simulated clock, after start(). The jobs run on
+         *  the calling thread as fast as they can, the operation time
+         *  grows with the simulated time but is not persisted.
+         *
+         * @param:  The span of simulated time in milliseconds
+         */
+        virtual void simulate(quint64 milliseconds);
+
+        /**
+         * @name:   Get Cycles / Missed Deadlines
+         * @brief:  Get the number of pump cycles / of missed deadlines
          *
-         * @return: The threads cycle time in seconds
+         *  The pump cycle runs on absolute deadlines of the monotonic
+         *  clock, the work time does not add up to a drift. A deadline
+         *  is missed when a cycle ends after the next one was due, or
+         *  when cycles were skipped after an overrun.
+         *
+         * @return: The number of cycles / of missed deadlines since start
+         */
+        virtual quint64 getCycles();
+        virtual quint64 getMissedDeadlines();
+
+        /**
+         * @name:   Get Cycle Statistics
+         * @brief:  Get the histograms of the pump cycle in microseconds
+         *
+         *  Lateness is the time from the deadline of a cycle to its start,
+         *  execution the time the cycle took
+         *
+         * @param:  Receives count, p50, p99, p999 and max of the lateness
+         * @param:  Receives count, p50, p99, p999 and max of the execution
+         */
+        virtual void getCycleStatistics(histogramsummary *lateness, histogramsummary *execution);
+
+        /**
+         * @name:   Get Statistics
+         * @brief:  Get the histograms of all jobs as text
+         *
+         * @return: One line per job with the lateness and execution percentiles
          */
-        virtual int getIntervalSec() const;
+        virtual QStringList getStatistics();
 
         /**
-         * @name:   Get/Set Thread
-         * @brief:  Get/Set the thread object of the schedulling thread
+         * @name:   Get Idle Statistics
+         * @brief:  Get the wake-ups & the CPU use since the last call
          *
-         * @param:  The thread object reference of the schedulling thread
-         * @return: The thread object reference of the schedulling thread
+         *  Wake-ups of the executor threads and of its timer loop per
+         *  minute of wall time, the CPU time of the whole process in
+         *  percent of the wall time. Mostly idle time between the jobs.
+         *
+         * @param:  Receives the wake-ups per minute
+         * @param:  Receives the CPU use in percent
+         */
+        virtual void getIdleStatistics(double *wakeupsPerMin, double *cpuPercent);
+
+        /**
+         * @name:   Is Tickless
+         * @brief:  Checks if the executor threads are woken by one timer loop
+         *
+         * @return: When the timer loop is used, 'true' is returned
          */
-        virtual std::thread* getThread() const;
-        virtual void setThread(std::thread* value);
+        virtual bool isTickless();
 
     private:
         /**
-         * @name:   Timer
-         * @brief:  QElapsedTimer object for measuring the system time
+         * @name:   Timer Start / Timer Valid
+         * @brief:  Start of the operation time measurement on the clock
          *
-         *  Timer of the Scheduler for measuring operation the systems
-         *  total operation time in hours
+         *  Measures the systems total operation time since the last
+         *  call of getOperationTime(), invalid while stopped,
+         *  guarded by 'Operation Time Lock'
          */
-        QElapsedTimer Timer;
+        std::chrono::steady_clock::time_point TimerStart;
+        bool TimerValid;
+
+        /**
+         * @name:   Idle Since / Idle CPU / Idle Wakeups
+         * @brief:  Wall time, process CPU time in seconds and executor
+         *          wake-ups at the last getIdleStatistics()
+         */
+        std::chrono::steady_clock::time_point IdleSince;
+        double IdleCpu;
+        uint64_t IdleWakeups;
 
         /**
          * @name:   Configuration File Name
@@ -170,10 +341,20 @@ class Scheduler : public QObject
          * @name:   Save File
          * @brief:  QSettings object for the configuration file
          *
-         *  File for saving the systems total operation time in hours
+         *  Only read for the total operation time of older versions,
+         *  written only when the journal can not be used
          */
         QSettings *SaveFile;
 
+        /**
+         * @name:   Journal
+         * @brief:  Persistence of the total operation time
+         *
+         *  Append-only journal next to the configuration file,
+         *  the static configuration is not rewritten anymore
+         */
+        OperationTimeJournal *Journal;
+
         /**
          * @name:   Total Operation Time
          * @brief:  The systems total operation time in milliseconds
@@ -184,6 +365,15 @@ class Scheduler : public QObject
          */
         quint64 TotalOperationTime;
 
+        /**
+         * @name:   Operation Time Lock
+         * @brief:  Guards the total operation time & the timer
+         *
+         *  Taken by the operation check, the persistence job and the
+         *  slot of the user interface, the journal only gets a copy
+         */
+        std::mutex OperationTimeLock;
+
         /**
          * @name:   The Pump
          * @brief:  A local representation of the Insulin Pump
@@ -191,30 +381,53 @@ class Scheduler : public QObject
         Pump *ThePump;
 
         /**
-         * @name:   Schould Run
-         * @brief:  Flag for the thread method
-         *
-         *  A flag for the thread method to check if it should run
-         *  If 'SchoulRun' is true, the scheduler thread loop will run
-         *  If 'ShouldRun' is flase, the thread stops the periodic checking
+         * @name:   The Clock
+         * @brief:  Time source of the jobs & the operation time
          */
-        bool SchouldRun;
+        Clock *TheClock;
 
         /**
-         * @name:   Interval Sec
-         * @brief:  Intervall in seconds for the thread method
+         * @name:   Executor
+         * @brief:  Runs the periodic jobs
          *
-         *  Intervall time in seconds for a single cycle
-         *  of the thread method
+         *  Pump cycle, persistence and the health checks of the
+         *  control system share its threads
+         */
+        JobExecutor Executor;
+
+        /**
+         * @name:   Pump Job
+         * @brief:  Number of the pump cycle job
          */
-        int IntervalSec;
+        int PumpJob;
 
         /**
-         * @name:   Thread
-         * @brief:  The thread object reference of the schedulling thread
+         * @name:   Adaptive
+         * @brief:  Interval policy of the pump cycle, used with AdaptiveSched
+         */
+        AdaptiveInterval Adaptive;
+        bool AdaptiveSched;
+
+        /**
+         * @name:   Cpu Affinity / Rt Priority / Lock Memory
+         * @brief:  Real-time settings of the configuration, the settings
+         *          that failed on a thread and if the memory is locked
+         */
+        int CpuAffinity;
+        int RtPriority;
+        bool LockMemory;
+        std::atomic<bool> AffinityFailed;
+        std::atomic<bool> PriorityFailed;
+        bool MemoryLocked;
+
+        /**
+         * @name:   Adapt Interval
+         * @brief:  Sets the pump cycle time from the readings & the battery
          *
+         *  Called by the pump job, the new time counts from the start
+         *  of the cycle that just finished
          */
-        std::thread *Thread;
+        virtual void adaptInterval();
 
         /**
          * @name:   Start Operation Time Counter
@@ -240,18 +453,21 @@ class Scheduler : public QObject
 
         /**
          * @name:   Read Operation Time
-         * @brief:  Reads the total operation time to the config file
+         * @brief:  Reads the total operation time from the journal
          *
-         *  Reads the old value from the configuration file from the section
-         *  “TotalOperationTime” and sets 'TotalOperationTime' in ms
+         *  Sets 'TotalOperationTime' in ms to the time recovered from the
+         *  journal. Without one, the old value from the configuration file
+         *  section “TotalOperationTime” is taken over.
          */
         virtual void readOperationTime();
 
         /**
          * @name:   Write Operation Time
-         * @brief:  Writes the total operation time to the config file
+         * @brief:  Writes the total operation time to the journal
          *
-         * Writes the actual total operation time to the configuration file
+         * Hands the actual total operation time to the journal, which
+         * commits it at most every JOURNAL_COMMIT_MS. Simulated time
+         * is never written.
          */
         virtual void writeOperationTime();
 
@@ -269,12 +485,12 @@ class Scheduler : public QObject
 
         /**
          * @name:   Set Interval Seconds
-         * @brief:  Set the threads cycle time in seconds
+         * @brief:  Set the pump cycle time in seconds
          *
          *  Public slot to set the cycle interval time in seconds
          *  and emit a signal to the user interface
          *
-         * @param:  The threads cycle time in seconds
+         * @param:  The pump cycle time in seconds
          */
         virtual void setIntervalSec(int value);
 
@@ -300,6 +516,15 @@ class Scheduler : public QObject
          * @param:  The new scheduler thread interval in seconds
          */
         void updateSchedulerThreadInterval(int seconds);
+
+        /**
+         * @name:   Deadline Missed
+         * @brief:  Event for the health monitoring
+         *
+         *  Emitted when the pump cycle missed deadlines, on the
+         *  executor thread that ran it
+         */
+        void deadlineMissed();
 };
 
 #endif
@@ -0,0 +1,181 @@
+/**
+ * @file:   SharedMemoryRing.cpp
+ * @class:  SharedMemoryRing
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Lock-free single-producer/single-consumer ring buffer
+ *          in POSIX shared memory for the Pump <-> Body exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "SharedMemoryRing.h"
+#include <new>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+
+
+/* The constructor maps (and on the body side creates) the ring
+ */
+SharedMemoryRing::SharedMemoryRing(const char *name, bool create)
+{
+    Name = name;
+    Creator = create;
+    Ring = NULL;
+    Inode = 0;
+
+    int flags = create ? (O_CREAT | O_RDWR) : O_RDWR;
+    int fd = shm_open(name, flags, 0600);
+    if(fd < 0)
+    {
+        return;
+    }
+
+    if(create && ftruncate(fd, sizeof(RingHeader)) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    struct stat status;
+    if(fstat(fd, &status) == 0)
+    {
+        Inode = status.st_ino;
+    }
+
+    void *mem = mmap(NULL, sizeof(RingHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mem == MAP_FAILED)
+    {
+        return;
+    }
+
+    RingHeader *ring = static_cast<RingHeader*>(mem);
+    if(create)
+    {
+        // Publish the magic last, the pump rejects the ring until then
+        ring->Slots = SHM_RING_SLOTS;
+        new (&ring->Head) atomic<uint64_t>(0);
+        new (&ring->Tail) atomic<uint64_t>(0);
+        atomic_thread_fence(memory_order_release);
+        ring->Magic = SHM_RING_MAGIC;
+    }
+    else if(ring->Magic != SHM_RING_MAGIC || ring->Slots != SHM_RING_SLOTS)
+    {
+        munmap(mem, sizeof(RingHeader));
+        return;
+    }
+
+    Ring = ring;
+}
+
+/* The destructor unmaps the ring, the creator also unlinks it
+ */
+SharedMemoryRing::~SharedMemoryRing()
+{
+    if(Ring)
+    {
+        if(Creator)
+        {
+            // the other side sees the ring is gone
+            Ring->Magic = 0;
+        }
+        munmap(Ring, sizeof(RingHeader));
+    }
+    if(Creator)
+    {
+        shm_unlink(Name);
+    }
+}
+
+
+/* Checks if the ring is mapped and initialised
+ */
+bool SharedMemoryRing::isValid() const
+{
+    return Ring != NULL;
+}
+
+/* Checks the magic & that the name still leads to the mapped object
+ */
+bool SharedMemoryRing::isCurrent() const
+{
+    if(!Ring || Ring->Magic != SHM_RING_MAGIC)
+    {
+        return false;
+    }
+
+    int fd = shm_open(Name, O_RDONLY, 0);
+    if(fd < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    bool current = fstat(fd, &status) == 0 && status.st_ino == Inode;
+    close(fd);
+
+    return current;
+}
+
+/* Appends a message, only ever called by the producing process
+ */
+bool SharedMemoryRing::push(const void *data, size_t size)
+{
+    if(!Ring || size > SHM_RING_SLOT_SIZE)
+    {
+        return false;
+    }
+
+    uint64_t head = Ring->Head.load(memory_order_relaxed);
+    if(head - Ring->Tail.load(memory_order_acquire) >= SHM_RING_SLOTS)
+    {
+        return false;
+    }
+
+    memcpy(Ring->Data[head & (SHM_RING_SLOTS-1)], data, size);
+    Ring->Head.store(head + 1, memory_order_release);
+
+    return true;
+}
+
+/* Takes the oldest message, only ever called by the consuming process
+ */
+bool SharedMemoryRing::pop(void *data, size_t size)
+{
+    if(!Ring || size > SHM_RING_SLOT_SIZE)
+    {
+        return false;
+    }
+
+    uint64_t tail = Ring->Tail.load(memory_order_relaxed);
+    if(tail == Ring->Head.load(memory_order_acquire))
+    {
+        return false;
+    }
+
+    memcpy(data, Ring->Data[tail & (SHM_RING_SLOTS-1)], size);
+    Ring->Tail.store(tail + 1, memory_order_release);
+
+    return true;
+}
+
+/* Drops all pending messages by moving the tail up to the head
+ */
+void SharedMemoryRing::clear()
+{
+    if(Ring)
+    {
+        Ring->Tail.store(Ring->Head.load(memory_order_acquire), memory_order_release);
+    }
+}
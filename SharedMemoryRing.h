@@ -0,0 +1,146 @@
+/**
+ * @file:   SharedMemoryRing.h
+ * @class:  SharedMemoryRing
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Lock-free single-producer/single-consumer ring buffer
+ *          in POSIX shared memory for the Pump <-> Body exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef sharedmemoryring_
+#define sharedmemoryring_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+
+#define SHM_RING_TO_PUMP    "/InsulinPump-to-pump"
+#define SHM_RING_TO_BODY    "/InsulinPump-to-body"
+#define SHM_RING_SLOTS      1024    // must be a power of two
+#define SHM_RING_SLOT_SIZE  32      // bytes per message
+#define SHM_RING_MAGIC      0x53434952
+
+
+class SharedMemoryRing
+{
+    public:
+        /**
+         * @name:   Shared Memory Ring
+         * @brief:  Shared Memory Ring Constructor
+         *
+         *  The creating side (the body) sets up and initialises the
+         *  shared memory object, the other side (the pump) only maps
+         *  an already existing one. Check isValid() afterwards.
+         *
+         * @param:  The name of the shared memory object
+         * @param:  'true' if the ring should be created
+         */
+        SharedMemoryRing(const char *name, bool create);
+
+        /**
+         * @name:   ~Shared Memory Ring
+         * @brief:  Shared Memory Ring Destructor
+         *
+         *  The destructor unmaps the ring, the creator also
+         *  removes the shared memory object
+         */
+        ~SharedMemoryRing();
+
+        /**
+         * @name:   Is Valid
+         * @brief:  Checks if the ring is mapped and initialised
+         *
+         * @return: When the ring can be used, 'true' is returned
+         */
+        bool isValid() const;
+
+        /**
+         * @name:   Is Current
+         * @brief:  Checks if the mapped ring is still the one of its name
+         *
+         *  Not the case once the creator removed or re-created the
+         *  shared memory object, or the magic is gone. Opens the object
+         *  by name, so only for the rare case of an empty ring.
+         *
+         * @return: When the mapping is still the ring, 'true' is returned
+         */
+        bool isCurrent() const;
+
+        /**
+         * @name:   Push
+         * @brief:  Appends a message to the ring (producer only)
+         *
+         * @param:  The message to append
+         * @param:  The size of the message, at most SHM_RING_SLOT_SIZE
+         * @return: When the ring is full or invalid, 'false' is returned
+         */
+        bool push(const void *data, size_t size);
+
+        /**
+         * @name:   Pop
+         * @brief:  Takes the oldest message from the ring (consumer only)
+         *
+         * @param:  The buffer for the message
+         * @param:  The size of the buffer, at most SHM_RING_SLOT_SIZE
+         * @return: When the ring is empty or invalid, 'false' is returned
+         */
+        bool pop(void *data, size_t size);
+
+        /**
+         * @name:   Clear
+         * @brief:  Drops all pending messages (consumer only)
+         */
+        void clear();
+
+    private:
+        /**
+         * @name:   Ring Header
+         * @brief:  Layout at the start of the shared memory object
+         *
+         *  Head and tail live on their own cache lines so producer
+         *  and consumer do not false-share. Both are free running
+         *  counters, the slot index is counter & (SHM_RING_SLOTS-1).
+         */
+        struct RingHeader
+        {
+            uint32_t Magic;
+            uint32_t Slots;
+            alignas(64) std::atomic<uint64_t> Head;  // next slot to write
+            alignas(64) std::atomic<uint64_t> Tail;  // next slot to read
+            alignas(64) unsigned char Data[SHM_RING_SLOTS][SHM_RING_SLOT_SIZE];
+        };
+
+        /**
+         * @name:   Name
+         * @brief:  Name of the shared memory object
+         */
+        const char *Name;
+
+        /**
+         * @name:   Creator
+         * @brief:  'true' if this side created the shared memory object
+         */
+        bool Creator;
+
+        /**
+         * @name:   Ring
+         * @brief:  The mapped ring, NULL if mapping failed
+         */
+        RingHeader *Ring;
+
+        /**
+         * @name:   Inode
+         * @brief:  Inode of the mapped shared memory object
+         */
+        ino_t Inode;
+};
+
+#endif
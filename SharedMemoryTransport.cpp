@@ -0,0 +1,98 @@
+/**
+ * @file:   SharedMemoryTransport.cpp
+ * @class:  SharedMemoryTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump side of the shared memory ring exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "SharedMemoryTransport.h"
+
+using namespace std;
+
+
+
+/* The rings are mapped on first use
+ */
+SharedMemoryTransport::SharedMemoryTransport()
+{
+    SensorRing = NULL;
+    InjectionRing = NULL;
+}
+
+/* The destructor unmaps the rings
+ */
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+    closeRings();
+}
+
+
+/* Pops the oldest sensor frame
+ */
+int SharedMemoryTransport::receiveFrame(wireframe *buffer)
+{
+    if(!openRings())
+    {
+        return 0;
+    }
+
+    if(!SensorRing->pop(buffer, sizeof(wireframe)))
+    {
+        // nothing yet, remap on next cycle only if the body is gone or restarted
+        if(!SensorRing->isCurrent() || !InjectionRing->isCurrent())
+        {
+            closeRings();
+        }
+        return 0;
+    }
+
+    return sizeof(wireframe);
+}
+
+/* Pushes an injection frame
+ */
+void SharedMemoryTransport::sendFrame(const wireframe *frame)
+{
+    if(openRings())
+    {
+        InjectionRing->push(frame, sizeof(wireframe));
+    }
+}
+
+
+/* Maps the rings created by the body
+ */
+bool SharedMemoryTransport::openRings()
+{
+    if(SensorRing && InjectionRing)
+    {
+        return true;
+    }
+
+    SensorRing = new SharedMemoryRing(SHM_RING_TO_PUMP, false);
+    InjectionRing = new SharedMemoryRing(SHM_RING_TO_BODY, false);
+    if(!SensorRing->isValid() || !InjectionRing->isValid())
+    {
+        closeRings();
+        return false;
+    }
+
+    return true;
+}
+
+/* Unmaps the rings
+ */
+void SharedMemoryTransport::closeRings()
+{
+    delete SensorRing;
+    delete InjectionRing;
+    SensorRing = NULL;
+    InjectionRing = NULL;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file:   SharedMemoryTransport.h
+ * @class:  SharedMemoryTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump side of the shared memory ring exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef sharedmemorytransport_
+#define sharedmemorytransport_
+
+#include "SharedMemoryRing.h"
+#include "Transport.h"
+
+
+
+class SharedMemoryTransport : public FrameTransport
+{
+    public:
+        /**
+         * @name:   Shared Memory Transport
+         * @brief:  Shared Memory Transport Constructor
+         *
+         *  The rings are created by the body and mapped on first use
+         */
+        SharedMemoryTransport();
+
+        /**
+         * @name:   ~Shared Memory Transport
+         * @brief:  Shared Memory Transport Destructor
+         */
+        ~SharedMemoryTransport();
+
+    protected:
+        /**
+         * @name:   Receive Frame
+         * @brief:  Pops the oldest frame of the body -> pump ring
+         *
+         * @param:  The buffer for the frame
+         * @return: The size of the frame, 0 if the ring is empty
+         */
+        virtual int receiveFrame(wireframe *buffer);
+
+        /**
+         * @name:   Send Frame
+         * @brief:  Pushes the frame to the pump -> body ring
+         *
+         * @param:  The frame
+         */
+        virtual void sendFrame(const wireframe *frame);
+
+    private:
+        /**
+         * @name:   Rings
+         * @brief:  Body -> pump and pump -> body, NULL until mapped
+         */
+        SharedMemoryRing *SensorRing;
+        SharedMemoryRing *InjectionRing;
+
+        /**
+         * @name:   Open/Close Rings
+         * @brief:  Maps the rings if not already done / unmaps them
+         *
+         * @return: When both rings are usable, 'true' is returned
+         */
+        bool openRings();
+        void closeRings();
+};
+
+#endif
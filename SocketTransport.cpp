@@ -0,0 +1,43 @@
+/**
+ * @file:   SocketTransport.cpp
+ * @class:  SocketTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump side of the unix domain socket exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "SocketTransport.h"
+
+using namespace std;
+
+
+
+/* Connects to the body on first use
+ */
+SocketTransport::SocketTransport() :
+    Channel(SOCKET_PATH, false)
+{
+}
+
+
+/* The body sends the next reading right after each injection
+ */
+int SocketTransport::receiveFrame(wireframe *buffer)
+{
+    int size = Channel.receive(buffer, sizeof(wireframe), SOCKET_READ_TIMEOUT_MS);
+
+    return size > 0 ? size : 0;
+}
+
+/* Sends an injection frame
+ */
+void SocketTransport::sendFrame(const wireframe *frame)
+{
+    Channel.send(frame, sizeof(wireframe));
+}
@@ -0,0 +1,60 @@
+/**
+ * @file:   SocketTransport.h
+ * @class:  SocketTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Pump side of the unix domain socket exchange
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef sockettransport_
+#define sockettransport_
+
+#include "Transport.h"
+#include "UnixSocketChannel.h"
+
+
+
+class SocketTransport : public FrameTransport
+{
+    public:
+        /**
+         * @name:   Socket Transport
+         * @brief:  Socket Transport Constructor
+         *
+         *  Connects to the body on first use
+         */
+        SocketTransport();
+
+    protected:
+        /**
+         * @name:   Receive Frame
+         * @brief:  Waits up to SOCKET_READ_TIMEOUT_MS for a sensor frame
+         *
+         * @param:  The buffer for the frame
+         * @return: The size of the frame, 0 if none arrived
+         */
+        virtual int receiveFrame(wireframe *buffer);
+
+        /**
+         * @name:   Send Frame
+         * @brief:  Sends the frame to the body
+         *
+         * @param:  The frame
+         */
+        virtual void sendFrame(const wireframe *frame);
+
+    private:
+        /**
+         * @name:   Channel
+         * @brief:  Client side of the body's socket
+         */
+        UnixSocketChannel Channel;
+};
+
+#endif
@@ -22,12 +22,30 @@ using namespace std;
 
 /* The constructor initializes the logfile
  */
-Tracer::Tracer()
+Tracer::Tracer(Clock *clock)
 {
+    TheClock = clock ? clock : Clock::getRealClock();
+
     // Copy the logfile name and open the file
-    LogFileName = LOGFILE_NAME;
+    LogFileName = TheClock->isSimulated() ? SIM_LOGFILE_NAME : LOGFILE_NAME;
     LogFile = new QFile(LogFileName);
     LogFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    PublishedStatus = -1;
+}
+
+/* The constructor with a given logfile, without a name the file stays closed
+ */
+Tracer::Tracer(QString filename, Clock *clock)
+{
+    TheClock = clock ? clock : Clock::getRealClock();
+
+    LogFileName = filename;
+    LogFile = new QFile(LogFileName);
+    if(!LogFileName.isEmpty())
+    {
+        LogFile->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    }
+    PublishedStatus = -1;
 }
 
 /* The destructor closes the logfile
@@ -48,13 +66,14 @@ bool Tracer::writeStatusLog(QString message)
     QTextStream TextStream(LogFile);
 
     // Add Timestamp and Tag
-    QString prefix = QDateTime::currentDateTime().toString("yyyy.MM.dd-HH:mm:ss") + " INFO: ";
+    QString prefix = TheClock->currentDateTime().toString("yyyy.MM.dd-HH:mm:ss") + " INFO: ";
 
     // Write to logfile
     TextStream << prefix << message  << endl;
 
     // Update UI with actually sent status message
     emit writeStatusLogInUi(prefix + message);
+    publishStatus();
 
     return true;
 }
@@ -67,13 +86,14 @@ bool Tracer::writeWarningLog(QString message)
     QTextStream TextStream(LogFile);
 
     // Add Timestamp and Tag
-    QString prefix = QDateTime::currentDateTime().toString("yyyy.MM.dd-HH:mm:ss") + " WARNING: ";
+    QString prefix = TheClock->currentDateTime().toString("yyyy.MM.dd-HH:mm:ss") + " WARNING: ";
 
     // Write to logfile
     TextStream << prefix << message  << endl;
 
     // Update UI with actually sent warning message
     emit writeWarningLogInUi(prefix + message);
+    publishStatus();
 
     return true;
 }
@@ -86,13 +106,14 @@ bool Tracer::writeCriticalLog(QString message)
     QTextStream TextStream(LogFile);
 
     // Add Timestamp and Tag
-    QString prefix = QDateTime::currentDateTime().toString("yyyy.MM.dd-HH:mm:ss") + " CRITICAL: ";
+    QString prefix = TheClock->currentDateTime().toString("yyyy.MM.dd-HH:mm:ss") + " CRITICAL: ";
 
     // Write to logfile
     TextStream << prefix << message  << endl;
 
     // Update UI with actually sent critical message
     emit writeCriticalLogInUi(prefix + message);
+    publishStatus();
 
     return true;
 }
@@ -130,6 +151,17 @@ int Tracer::getStatus()
     return 0;
 }
 
+/* Publishes a changed status, once per change
+ */
+void Tracer::publishStatus()
+{
+    int status = getStatus();
+    if(PublishedStatus.exchange(status) != status)
+    {
+        emit statusChanged(status);
+    }
+}
+
 
 /* Getter & Setter for the file name of the logfile
  */
@@ -17,15 +17,18 @@
 #ifndef tracer_
 #define tracer_
 
+#include <atomic>
 #include <iostream>
 #include <QApplication>
 #include <QDateTime>
 #include <QFile>
 #include <QString>
+#include "Clock.h"
 #include <QTextStream>
 
 
 #define LOGFILE_NAME "InsulinPump.log"
+#define SIM_LOGFILE_NAME "InsulinPump.sim.log"   // runs in simulated time
 
 
 
@@ -38,9 +41,12 @@ class Tracer : public QObject
          * @name:   Tracer
          * @brief:  Tracer Constructor
          *
-         *  The constructor initializes the logfile
+         *  The constructor initializes the logfile, with a simulated
+         *  clock a separate one
+         *
+         * @param:  The clock of the timestamps, NULL for the real clock
          */
-        Tracer();
+        Tracer(Clock *clock = NULL);
 
         /**
          * @name:   ~Tracer
@@ -129,6 +135,20 @@ class Tracer : public QObject
         virtual QString getLogFileName() const;
         virtual void setLogFileName(QString value);
 
+    protected:
+        /**
+         * @name:   Tracer
+         * @brief:  Tracer Constructor with a given logfile
+         *
+         *  For tracers that write the messages elsewhere: with an empty
+         *  file name no file is opened or created, getStatus() then
+         *  reports the logfile as not open
+         *
+         * @param:  The filename of the logfile, empty for none
+         * @param:  The clock of the timestamps, NULL for the real clock
+         */
+        Tracer(QString filename, Clock *clock = NULL);
+
     private:
         /**
          * @name:   Log File Name
@@ -146,6 +166,25 @@ class Tracer : public QObject
          */
         QFile *LogFile;
 
+        /**
+         * @name:   The Clock
+         * @brief:  Time source of the timestamps
+         */
+        Clock *TheClock;
+
+        /**
+         * @name:   Published Status
+         * @brief:  Status of the last statusChanged(), -1 before the first
+         */
+        std::atomic<int> PublishedStatus;
+
+        /**
+         * @name:   Publish Status
+         * @brief:  Emits statusChanged() if the status differs from the
+         *          last published one, called after every write
+         */
+        void publishStatus();
+
     signals:
         /**
          * @name:   Write Status Log To User Interface
@@ -180,6 +219,17 @@ class Tracer : public QObject
          */
         void writeCriticalLogInUi(QString message);
 
+        /**
+         * @name:   Status Changed
+         * @brief:  Event for the health monitoring
+         *
+         *  Emitted by a write that finds the logfile closed or no longer
+         *  writeable, or writeable again, on the writing thread
+         *
+         * @param: The new status, see getStatus()
+         */
+        void statusChanged(int status);
+
 };
 
 #endif
@@ -0,0 +1,65 @@
+/**
+ * @file:   Transport.cpp
+ * @class:  FrameTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Interfaces between the pump and the body it is connected to
+ *          Common base for the transports carrying wire frames
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "Transport.h"
+
+using namespace std;
+
+
+
+/* The pump sends injections and receives readings
+ */
+FrameTransport::FrameTransport() :
+    Wire(WIRE_INJECTION, WIRE_SENSOR)
+{
+}
+
+
+/* Receives the next valid sensor frame
+ */
+int FrameTransport::readBloodSugarLevel()
+{
+    wireframe buffer, frame;
+    int size, status;
+
+    do
+    {
+        size = receiveFrame(&buffer);
+        if(size <= 0)
+        {
+            return -1;
+        }
+        status = Wire.decode(&buffer, size, &frame);
+    }
+    while(status == WIRE_STALE || status == WIRE_CORRUPT);
+
+    return (int)WireProtocol::getValue(frame.value);
+}
+
+/* Sensor frames missing in the received sequence
+ */
+uint32_t FrameTransport::getLostReadings() const
+{
+    return Wire.getLostFrames();
+}
+
+/* Encodes and sends one injection frame
+ */
+void FrameTransport::injectHormones(int insulinUnits, int glucagonUnits)
+{
+    wireframe frame;
+    Wire.encode(&frame, insulinUnits, glucagonUnits);
+    sendFrame(&frame);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file:   Transport.h
+ * @class:  SensorTransport, InjectionTransport, FrameTransport
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Interfaces between the pump and the body it is connected to
+ *          Common base for the transports carrying wire frames
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef transport_
+#define transport_
+
+#include "WireProtocol.h"
+
+
+
+class SensorTransport
+{
+    public:
+        virtual ~SensorTransport() {}
+
+        /**
+         * @name:   Read Blood Sugar Level
+         * @brief:  Reads the next blood sugar level from the body
+         *
+         * @return: The blood sugar level in mg/dL, -1 if there is none
+         */
+        virtual int readBloodSugarLevel() = 0;
+
+        /**
+         * @name:   Get Lost Readings
+         * @brief:  Number of readings lost on the way so far
+         *
+         * @return: The number of lost readings
+         */
+        virtual uint32_t getLostReadings() const { return 0; }
+};
+
+
+class InjectionTransport
+{
+    public:
+        virtual ~InjectionTransport() {}
+
+        /**
+         * @name:   Inject Hormones
+         * @brief:  Hands the calculated units over to the body
+         *
+         * @param:  Units of insulin to inject
+         * @param:  Units of glucagon to inject
+         */
+        virtual void injectHormones(int insulinUnits, int glucagonUnits) = 0;
+};
+
+
+class FrameTransport : public SensorTransport, public InjectionTransport
+{
+    public:
+        /**
+         * @name:   Frame Transport
+         * @brief:  Frame Transport Constructor
+         */
+        FrameTransport();
+
+        /**
+         * @name:   Read Blood Sugar Level
+         * @brief:  Receives and decodes the next sensor frame
+         *
+         *  Stale and corrupt frames are dropped and the next one is tried
+         *
+         * @return: The blood sugar level in mg/dL, -1 if there is none
+         */
+        virtual int readBloodSugarLevel();
+
+        /**
+         * @name:   Get Lost Readings
+         * @brief:  Sensor frames missing in the received sequence
+         *
+         * @return: The number of lost sensor frames
+         */
+        virtual uint32_t getLostReadings() const;
+
+        /**
+         * @name:   Inject Hormones
+         * @brief:  Encodes and sends one injection frame
+         *
+         * @param:  Units of insulin to inject
+         * @param:  Units of glucagon to inject
+         */
+        virtual void injectHormones(int insulinUnits, int glucagonUnits);
+
+    protected:
+        /**
+         * @name:   Receive Frame
+         * @brief:  Receives the raw bytes of one sensor frame
+         *
+         * @param:  The buffer for the frame
+         * @return: The number of bytes received, 0 if there was nothing
+         */
+        virtual int receiveFrame(wireframe *buffer) = 0;
+
+        /**
+         * @name:   Send Frame
+         * @brief:  Sends one encoded injection frame
+         *
+         * @param:  The frame
+         */
+        virtual void sendFrame(const wireframe *frame) = 0;
+
+    private:
+        /**
+         * @name:   Wire
+         * @brief:  Frame sequencing & checking for both directions
+         */
+        WireProtocol Wire;
+};
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ * @file:   UnixSocketChannel.cpp
+ * @class:  UnixSocketChannel
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Event driven Unix domain socket for the Pump <-> Body exchange
+ *          Blocks in epoll until a message arrives
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "UnixSocketChannel.h"
+#include <chrono>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+
+
+/* Remaining milliseconds until the deadline, -1 stays forever
+ */
+static int remainingMs(int timeoutMs, chrono::steady_clock::time_point deadline)
+{
+    if(timeoutMs < 0)
+    {
+        return -1;
+    }
+
+    chrono::steady_clock::duration left = deadline - chrono::steady_clock::now();
+    if(left <= chrono::steady_clock::duration::zero())
+    {
+        return 0;
+    }
+    return (int)chrono::duration_cast<chrono::milliseconds>(left).count() + 1;
+}
+
+
+/* The constructor sets up epoll, the server also starts listening
+ */
+UnixSocketChannel::UnixSocketChannel(const char *path, bool server)
+{
+    Path = path;
+    Server = server;
+    ListenFd = -1;
+    Fd = -1;
+
+    EpollFd = epoll_create1(EPOLL_CLOEXEC);
+    WakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = WakeFd;
+    epoll_ctl(EpollFd, EPOLL_CTL_ADD, WakeFd, &ev);
+
+    if(!server)
+    {
+        return;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    ListenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    unlink(path);
+    if(bind(ListenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+       listen(ListenFd, 1) != 0)
+    {
+        close(ListenFd);
+        ListenFd = -1;
+        return;
+    }
+
+    ev.data.fd = ListenFd;
+    epoll_ctl(EpollFd, EPOLL_CTL_ADD, ListenFd, &ev);
+}
+
+/* The destructor closes all descriptors
+ */
+UnixSocketChannel::~UnixSocketChannel()
+{
+    dropConnection();
+    if(ListenFd >= 0)
+    {
+        close(ListenFd);
+        unlink(Path);
+    }
+    close(WakeFd);
+    close(EpollFd);
+}
+
+
+/* Checks if the channel could be set up
+ */
+bool UnixSocketChannel::isValid() const
+{
+    return EpollFd >= 0 && WakeFd >= 0 && (!Server || ListenFd >= 0);
+}
+
+/* Checks if a peer is connected
+ */
+bool UnixSocketChannel::isConnected() const
+{
+    return Fd >= 0;
+}
+
+/* Waits for a peer, the client simply tries to connect
+ */
+bool UnixSocketChannel::waitConnected(int timeoutMs)
+{
+    if(!Server)
+    {
+        return isConnected() || connectToServer();
+    }
+
+    chrono::steady_clock::time_point deadline =
+            chrono::steady_clock::now() + chrono::milliseconds(timeoutMs);
+    while(!isConnected())
+    {
+        int events = waitEvent(remainingMs(timeoutMs, deadline));
+        if(events == 0 || (events & CHANNEL_WAKEUP))
+        {
+            break;
+        }
+    }
+
+    return isConnected();
+}
+
+/* Sends one message to the peer
+ */
+bool UnixSocketChannel::send(const void *data, size_t size)
+{
+    if(!isConnected())
+    {
+        return false;
+    }
+
+    if(::send(Fd, data, size, MSG_NOSIGNAL) != (ssize_t)size)
+    {
+        dropConnection();
+        return false;
+    }
+
+    return true;
+}
+
+/* Waits in epoll for one message from the peer
+ */
+int UnixSocketChannel::receive(void *data, size_t size, int timeoutMs)
+{
+    chrono::steady_clock::time_point deadline =
+            chrono::steady_clock::now() + chrono::milliseconds(timeoutMs);
+
+    if(!waitConnected(timeoutMs))
+    {
+        return 0;
+    }
+
+    while(true)
+    {
+        int events = waitEvent(remainingMs(timeoutMs, deadline));
+        if(events & CHANNEL_ACCEPTED)
+        {
+            // a new pump replaced the old one, the exchange starts over
+            return -1;
+        }
+        if(!(events & CHANNEL_READABLE))
+        {
+            return (events & (CHANNEL_WAKEUP | CHANNEL_SIGNAL)) ? CHANNEL_WOKEN : 0;
+        }
+
+        ssize_t n = recv(Fd, data, size, 0);
+        if(n > 0)
+        {
+            return (int)n;
+        }
+        if(n < 0 && (errno == EAGAIN || errno == EINTR))
+        {
+            continue;
+        }
+        dropConnection();
+        return -1;
+    }
+}
+
+/* Interrupts a blocking wait, safe from any thread
+ */
+void UnixSocketChannel::wakeup()
+{
+    uint64_t one = 1;
+    if(write(WakeFd, &one, sizeof(one)) != sizeof(one))
+    {
+        // counter saturated, a wakeup is pending anyway
+    }
+}
+
+
+/* Client side connect
+ */
+bool UnixSocketChannel::connectToServer()
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, Path, sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if(fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        return false;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(EpollFd, EPOLL_CTL_ADD, fd, &ev);
+    Fd = fd;
+
+    return true;
+}
+
+/* Server side accept, a new pump replaces the old connection
+ */
+void UnixSocketChannel::acceptClient()
+{
+    int fd = accept4(ListenFd, NULL, NULL, SOCK_CLOEXEC);
+    if(fd < 0)
+    {
+        return;
+    }
+
+    dropConnection();
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(EpollFd, EPOLL_CTL_ADD, fd, &ev);
+    Fd = fd;
+}
+
+/* Closes the connection
+ */
+void UnixSocketChannel::dropConnection()
+{
+    if(Fd >= 0)
+    {
+        epoll_ctl(EpollFd, EPOLL_CTL_DEL, Fd, NULL);
+        close(Fd);
+        Fd = -1;
+    }
+}
+
+/* Waits in epoll, accepts new peers and swallows wakeups
+ */
+int UnixSocketChannel::waitEvent(int timeoutMs)
+{
+    struct epoll_event events[3];
+    int n = epoll_wait(EpollFd, events, 3, timeoutMs);
+    int result = 0;
+
+    if(n < 0 && errno == EINTR)
+    {
+        result |= CHANNEL_SIGNAL;
+    }
+
+    for(int i = 0; i < n; i++)
+    {
+        if(events[i].data.fd == WakeFd)
+        {
+            uint64_t count;
+            if(read(WakeFd, &count, sizeof(count)) < 0)
+            {
+                // nothing pending
+            }
+            result |= CHANNEL_WAKEUP;
+        }
+        else if(events[i].data.fd == ListenFd)
+        {
+            acceptClient();
+            result |= CHANNEL_ACCEPTED;
+        }
+        else if(events[i].data.fd == Fd)
+        {
+            result |= CHANNEL_READABLE;
+        }
+    }
+
+    return result;
+}
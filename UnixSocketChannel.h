@@ -0,0 +1,169 @@
+/**
+ * @file:   UnixSocketChannel.h
+ * @class:  UnixSocketChannel
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Event driven Unix domain socket for the Pump <-> Body exchange
+ *          Blocks in epoll until a message arrives
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef unixsocketchannel_
+#define unixsocketchannel_
+
+#include <stddef.h>
+
+
+#define SOCKET_PATH             "InsulinPump.sock"
+#define SOCKET_READ_TIMEOUT_MS  100     // pump side wait for a reading
+
+#define CHANNEL_READABLE        1       // waitEvent(): connection readable
+#define CHANNEL_WAKEUP          2       // waitEvent(): wakeup() was called
+#define CHANNEL_ACCEPTED        4       // waitEvent(): a new peer connected
+#define CHANNEL_SIGNAL          8       // waitEvent(): interrupted by a signal
+
+#define CHANNEL_WOKEN           -2      // receive(): wakeup() or a signal, no message
+
+
+
+class UnixSocketChannel
+{
+    public:
+        /**
+         * @name:   Unix Socket Channel
+         * @brief:  Unix Socket Channel Constructor
+         *
+         *  The server side (the body) binds and listens on the socket
+         *  path, the client side (the pump) connects on first use and
+         *  reconnects whenever the body went away.
+         *
+         * @param:  The file system path of the socket
+         * @param:  'true' for the listening side
+         */
+        UnixSocketChannel(const char *path, bool server);
+
+        /**
+         * @name:   ~Unix Socket Channel
+         * @brief:  Unix Socket Channel Destructor
+         *
+         *  The destructor closes all descriptors, the server
+         *  also removes the socket path
+         */
+        ~UnixSocketChannel();
+
+        /**
+         * @name:   Is Valid
+         * @brief:  Checks if the channel could be set up
+         *
+         * @return: When epoll (and on the server the listener) is ready,
+         *          'true' is returned
+         */
+        bool isValid() const;
+
+        /**
+         * @name:   Is Connected
+         * @brief:  Checks if a peer is connected
+         *
+         * @return: When a peer is connected, 'true' is returned
+         */
+        bool isConnected() const;
+
+        /**
+         * @name:   Wait Connected
+         * @brief:  Waits for a peer, connecting or accepting as needed
+         *
+         * @param:  Timeout in milliseconds, -1 waits forever
+         * @return: When a peer is connected, 'true' is returned
+         */
+        bool waitConnected(int timeoutMs);
+
+        /**
+         * @name:   Send
+         * @brief:  Sends one message to the peer
+         *
+         * @param:  The message to send
+         * @param:  The size of the message
+         * @return: When the message was sent, 'true' is returned
+         */
+        bool send(const void *data, size_t size);
+
+        /**
+         * @name:   Receive
+         * @brief:  Waits in epoll for one message from the peer
+         *
+         * @param:  The buffer for the message
+         * @param:  The size of the buffer
+         * @param:  Timeout in milliseconds, -1 waits forever
+         * @return: The size of the message when one was received,
+         *          0 on timeout or without a peer,
+         *          CHANNEL_WOKEN on wakeup() or a signal,
+         *         -1 when the peer disconnected or was replaced
+         */
+        int receive(void *data, size_t size, int timeoutMs);
+
+        /**
+         * @name:   Wakeup
+         * @brief:  Interrupts a blocking waitConnected() or receive()
+         *
+         *  May be called from any thread, e.g. on shutdown
+         */
+        void wakeup();
+
+    private:
+        /**
+         * @name:   Path
+         * @brief:  File system path of the socket
+         */
+        const char *Path;
+
+        /**
+         * @name:   Server
+         * @brief:  'true' on the listening side
+         */
+        bool Server;
+
+        /**
+         * @name:   Descriptors
+         * @brief:  Listener (server only), connection, epoll and wakeup eventfd
+         */
+        int ListenFd;
+        int Fd;
+        int EpollFd;
+        int WakeFd;
+
+        /**
+         * @name:   Connect To Server
+         * @brief:  Client side connect, registers the connection in epoll
+         *
+         * @return: When connected, 'true' is returned
+         */
+        bool connectToServer();
+
+        /**
+         * @name:   Accept Client
+         * @brief:  Server side accept, replaces any old connection
+         */
+        void acceptClient();
+
+        /**
+         * @name:   Drop Connection
+         * @brief:  Closes the connection and removes it from epoll
+         */
+        void dropConnection();
+
+        /**
+         * @name:   Wait Event
+         * @brief:  Waits in epoll and handles listener & wakeup events
+         *
+         * @param:  Timeout in milliseconds, -1 waits forever
+         * @return: The CHANNEL_* events that occured, 0 on timeout
+         */
+        int waitEvent(int timeoutMs);
+};
+
+#endif
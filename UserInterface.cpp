@@ -26,7 +26,6 @@
 #include "iostream"
 #include <string>
 #include <QString>
-#include <QTime>
 #include <QTimer>
 #include <QPixmap>
 
@@ -35,7 +34,8 @@ using namespace std;
 
 UserInterface::UserInterface(QWidget *parent) :
     QMainWindow(parent),
-    ui(new Ui::UserInterface)
+    ui(new Ui::UserInterface),
+    clock(Clock::getRealClock())
 {
     ui->setupUi(this);
 
@@ -47,7 +47,7 @@ UserInterface::UserInterface(QWidget *parent) :
     // Init Time
     QTimer *timer = new QTimer(this);
     connect(timer, SIGNAL(timeout()), this, SLOT(updateClock()));
-    timer->start();
+    timer->start(UI_CLOCK_MS);
     updateClock();
 }
 
@@ -85,6 +85,17 @@ void UserInterface::init(config cfg)
     ui->mBloodSugarValue->setStyleSheet(string);
 }
 
+/**
+ * Sets the clock of the time display and the injection log
+ *
+ * @param clock - time source, the real clock until set
+ */
+void UserInterface::setClock(Clock *clock)
+{
+    this->clock = clock;
+    updateClock();
+}
+
 /**
  * Updates the Batteries power level in the Progressbar
  *
@@ -284,10 +295,8 @@ void UserInterface::on_mGlucagonRefillButton_clicked()
  */
 void UserInterface::updateClock()
 {
-    // Get Time
-    QTime time = QTime::currentTime();
-    // Format and set Time
-    QString text = time.toString("hh:mm:ss");
+    // Get, format and set Time
+    QString text = clock->currentDateTime().toString("hh:mm:ss");
     ui->mTimeValue->setText(text);
 }
 
@@ -325,8 +334,7 @@ void UserInterface::updateBloodsugarLevel(int bloodsugarLevel)
 void UserInterface::updateHormoneInjectionLog(int hormone, int amountInjected)
 {
     // Timestamp
-    QTime time = QTime::currentTime();
-    QString text = time.toString("hh:mm:ss");
+    QString text = clock->currentDateTime().toString("hh:mm:ss");
     // Insert Message
     if (hormone == INSULIN)
     {
@@ -345,6 +353,17 @@ void UserInterface::updateHormoneInjectionLog(int hormone, int amountInjected)
     }
 }
 
+/**
+ * Replaces the scheduler diagnostics with the latest histograms
+ *
+ * @param lines - one line per scheduler job
+ */
+void UserInterface::updateDiagnostics(QStringList lines)
+{
+    ui->mDiagnosticsList->clear();
+    ui->mDiagnosticsList->addItems(lines);
+}
+
 /**
  * Testing onBatteryButtonClicked
  *
@@ -27,12 +27,17 @@
 #include <QMainWindow>
 #include <QMouseEvent>
 #include <QString>
+#include <QStringList>
 #include <string>
+#include <Clock.h>
 #include <Pump.h>
 
 using namespace std;
 
 
+#define UI_CLOCK_MS     1000    // the clock shows seconds, no faster refresh
+
+
 
 namespace Ui {
 class UserInterface;
@@ -56,6 +61,13 @@ public:
      */
     void init(config cfg);
 
+    /**
+     * Sets the clock of the time display and the injection log
+     *
+     * @param clock - time source, the real clock until set
+     */
+    void setClock(Clock *clock);
+
 public slots:
     /**
      * Updates the Batteries power level in the Progressbar
@@ -139,6 +151,13 @@ public slots:
      */
     void updateHormoneInjectionLog(int hormone, int amountInjected);
 
+    /**
+     * Replaces the scheduler diagnostics with the latest histograms
+     *
+     * @param lines - one line per scheduler job
+     */
+    void updateDiagnostics(QStringList lines);
+
 private slots:
     /**
      * Refill the Insulinreservoir in the Pump
@@ -291,6 +310,7 @@ private:
     int resCrit;
     int battWarn;
     int battCrit;
+    Clock *clock;
 };
 
 #endif // USERINTERFACE_H
@@ -0,0 +1,153 @@
+/**
+ * @file:   WireProtocol.cpp
+ * @class:  WireProtocol
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Fixed size binary frames for the Pump <-> Body exchange
+ *          Sequence numbers, monotonic timestamps and a checksum
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "WireProtocol.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+
+
+/* The constructor starts both sequences from scratch
+ */
+WireProtocol::WireProtocol(uint8_t sendType, uint8_t receiveType)
+{
+    SendType = sendType;
+    ReceiveType = receiveType;
+    SendSequence = 0;
+    ReceiveSequence = 0;
+    LostFrames = 0;
+    StaleFrames = 0;
+    CorruptFrames = 0;
+}
+
+
+/* Fills the next outgoing frame
+ */
+void WireProtocol::encode(wireframe *frame, double value, double value2)
+{
+    frame->magic = WIRE_MAGIC;
+    frame->type = SendType;
+    frame->reserved = 0;
+    frame->sequence = ++SendSequence;
+    frame->timestamp = monotonicTime();
+    frame->value = (int32_t)lround(value * WIRE_FIXED_SCALE);
+    frame->value2 = (int32_t)lround(value2 * WIRE_FIXED_SCALE);
+    frame->checksum = checksum(frame);
+    frame->padding = 0;
+}
+
+/* Verifies an incoming frame and tracks its sequence
+ */
+int WireProtocol::decode(const void *buffer, size_t size, wireframe *frame)
+{
+    if(size != sizeof(wireframe))
+    {
+        CorruptFrames++;
+        return WIRE_CORRUPT;
+    }
+
+    memcpy(frame, buffer, sizeof(wireframe));
+    if(frame->magic != WIRE_MAGIC || frame->type != ReceiveType ||
+       frame->checksum != checksum(frame))
+    {
+        CorruptFrames++;
+        return WIRE_CORRUPT;
+    }
+
+    // A sender always starts with 1, so a 1 means the peer restarted
+    if(frame->sequence == 1)
+    {
+        ReceiveSequence = 1;
+        return WIRE_OK;
+    }
+
+    if(frame->sequence <= ReceiveSequence)
+    {
+        StaleFrames++;
+        return WIRE_STALE;
+    }
+
+    uint32_t missing = frame->sequence - ReceiveSequence - 1;
+    ReceiveSequence = frame->sequence;
+    if(missing > 0)
+    {
+        LostFrames += missing;
+        return WIRE_LOST;
+    }
+
+    return WIRE_OK;
+}
+
+
+/* Counters of the frames decode() complained about
+ */
+uint32_t WireProtocol::getLostFrames() const
+{
+    return LostFrames;
+}
+
+uint32_t WireProtocol::getStaleFrames() const
+{
+    return StaleFrames;
+}
+
+uint32_t WireProtocol::getCorruptFrames() const
+{
+    return CorruptFrames;
+}
+
+
+/* Converts a fixed point value back
+ */
+double WireProtocol::getValue(int32_t fixed)
+{
+    return (double)fixed / WIRE_FIXED_SCALE;
+}
+
+/* Age of a received frame
+ */
+uint64_t WireProtocol::getAge(const wireframe *frame)
+{
+    uint64_t now = monotonicTime();
+    return now > frame->timestamp ? now - frame->timestamp : 0;
+}
+
+/* CLOCK_MONOTONIC in ns
+ */
+uint64_t WireProtocol::monotonicTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* FNV-1a over everything in front of the checksum field
+ */
+uint32_t WireProtocol::checksum(const wireframe *frame)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(frame);
+    uint32_t hash = 2166136261u;
+
+    for(size_t i = 0; i < offsetof(wireframe, checksum); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
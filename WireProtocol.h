@@ -0,0 +1,172 @@
+/**
+ * @file:   WireProtocol.h
+ * @class:  WireProtocol
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Fixed size binary frames for the Pump <-> Body exchange
+ *          Sequence numbers, monotonic timestamps and a checksum
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef wireprotocol_
+#define wireprotocol_
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define WIRE_MAGIC          0x5049  // "IP"
+#define WIRE_SENSOR         1       // body -> pump, value = BSL
+#define WIRE_INJECTION      2       // pump -> body, value = insulin, value2 = glucagon
+#define WIRE_FIXED_SCALE    100     // values are transmitted as value * WIRE_FIXED_SCALE
+
+#define WIRE_OK             0       // decode(): frame accepted
+#define WIRE_LOST           1       // decode(): frame accepted, frames before it are missing
+#define WIRE_STALE          2       // decode(): frame dropped, not newer than the last one
+#define WIRE_CORRUPT        3       // decode(): frame dropped, bad size, magic, type or checksum
+
+
+/**
+ * @name        Wire Frame
+ * @brief       One message on the wire, in host byte order
+ *
+ *  Magic       WIRE_MAGIC
+ *  Type        WIRE_SENSOR or WIRE_INJECTION
+ *  Sequence    Per sender, starting at 1 (a 1 resets the receiver)
+ *  Timestamp   CLOCK_MONOTONIC of the sender in ns
+ *  Value       Reading in mg/dL or insulin units, fixed point
+ *  Value2      Glucagon units, fixed point, 0 for readings
+ *  Checksum    FNV-1a over all preceding bytes
+ */
+struct wireframe{
+    uint16_t magic;
+    uint8_t  type;
+    uint8_t  reserved;
+    uint32_t sequence;
+    uint64_t timestamp;
+    int32_t  value;
+    int32_t  value2;
+    uint32_t checksum;
+    uint32_t padding;
+};
+
+static_assert(sizeof(wireframe) == 32, "wireframe must stay 32 bytes");
+
+
+
+class WireProtocol
+{
+    public:
+        /**
+         * @name:   Wire Protocol
+         * @brief:  Wire Protocol Constructor
+         *
+         * @param:  The type of the frames this side sends
+         * @param:  The type of the frames this side receives
+         */
+        WireProtocol(uint8_t sendType, uint8_t receiveType);
+
+        /**
+         * @name:   Encode
+         * @brief:  Fills the next outgoing frame
+         *
+         *  Stamps the next sequence number and the monotonic time
+         *  and calculates the checksum
+         *
+         * @param:  The frame to fill
+         * @param:  The first value (not yet scaled)
+         * @param:  The second value (not yet scaled)
+         */
+        void encode(wireframe *frame, double value, double value2);
+
+        /**
+         * @name:   Decode
+         * @brief:  Verifies an incoming frame and tracks its sequence
+         *
+         * @param:  The received bytes
+         * @param:  The number of received bytes
+         * @param:  The frame to copy the bytes to
+         * @return: One of WIRE_OK, WIRE_LOST, WIRE_STALE, WIRE_CORRUPT
+         */
+        int decode(const void *buffer, size_t size, wireframe *frame);
+
+        /**
+         * @name:   Get Lost/Stale/Corrupt Frames
+         * @brief:  Counters of the frames decode() complained about
+         *
+         * @return: The number of frames
+         */
+        uint32_t getLostFrames() const;
+        uint32_t getStaleFrames() const;
+        uint32_t getCorruptFrames() const;
+
+        /**
+         * @name:   Get Value
+         * @brief:  Converts a fixed point value of a frame back
+         *
+         * @param:  The fixed point value
+         * @return: The value
+         */
+        static double getValue(int32_t fixed);
+
+        /**
+         * @name:   Get Age
+         * @brief:  Age of a received frame in ns
+         *
+         * @param:  The frame
+         * @return: Nanoseconds since the frame was encoded
+         */
+        static uint64_t getAge(const wireframe *frame);
+
+        /**
+         * @name:   Monotonic Time
+         * @brief:  CLOCK_MONOTONIC in ns, the same in both processes
+         *
+         * @return: The monotonic time in ns
+         */
+        static uint64_t monotonicTime();
+
+    private:
+        /**
+         * @name:   Send/Receive Type
+         * @brief:  The frame types of both directions
+         */
+        uint8_t SendType;
+        uint8_t ReceiveType;
+
+        /**
+         * @name:   Send Sequence
+         * @brief:  Sequence number of the last encoded frame
+         */
+        uint32_t SendSequence;
+
+        /**
+         * @name:   Receive Sequence
+         * @brief:  Sequence number of the last accepted frame, 0 if none
+         */
+        uint32_t ReceiveSequence;
+
+        /**
+         * @name:   Counters
+         * @brief:  Lost, stale and corrupt frames since construction
+         */
+        uint32_t LostFrames;
+        uint32_t StaleFrames;
+        uint32_t CorruptFrames;
+
+        /**
+         * @name:   Checksum
+         * @brief:  FNV-1a over everything in front of the checksum field
+         *
+         * @param:  The frame
+         * @return: The checksum
+         */
+        static uint32_t checksum(const wireframe *frame);
+};
+
+#endif
@@ -0,0 +1,176 @@
+/**
+ * @file:   WorkStealingPool.cpp
+ * @class:  WorkStealingPool
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Thread pool with one task queue per worker
+ *          Idle workers steal from the queues of the others
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+
+
+/* The constructor starts the workers
+ */
+WorkStealingPool::WorkStealingPool(int threads) :
+    Queued(0),
+    Pending(0),
+    NextQueue(0),
+    Stolen(0),
+    Stop(false)
+{
+    if(threads <= 0)
+    {
+        threads = thread::hardware_concurrency();
+    }
+    if(threads <= 0)
+    {
+        threads = 1;
+    }
+
+    for(int i = 0; i < threads; i++)
+    {
+        Queues.push_back(unique_ptr<taskqueue>(new taskqueue()));
+    }
+    for(int i = 0; i < threads; i++)
+    {
+        Workers.push_back(thread(&WorkStealingPool::work, this, i));
+    }
+}
+
+/* The destructor finishes the queued tasks and joins the workers
+ */
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+
+    {
+        lock_guard<mutex> lock(IdleLock);
+        Stop = true;
+    }
+    IdleCondition.notify_all();
+
+    for(size_t i = 0; i < Workers.size(); i++)
+    {
+        Workers[i].join();
+    }
+}
+
+
+/* Queues a task round robin and wakes an idle worker
+ */
+void WorkStealingPool::submit(function<void()> task)
+{
+    taskqueue *queue = Queues[NextQueue++ % Queues.size()].get();
+
+    Pending++;
+    {
+        lock_guard<mutex> lock(queue->lock);
+        queue->tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> lock(IdleLock);
+        Queued++;
+    }
+    IdleCondition.notify_one();
+}
+
+/* Blocks until all submitted tasks are done
+ */
+void WorkStealingPool::wait()
+{
+    unique_lock<mutex> lock(IdleLock);
+    DoneCondition.wait(lock, [this]{ return Pending == 0; });
+}
+
+
+/* Getter for the number of workers & stolen tasks
+ */
+int WorkStealingPool::getThreadCount() const
+{
+    return Workers.size();
+}
+
+uint64_t WorkStealingPool::getStolenTasks() const
+{
+    return Stolen;
+}
+
+
+/* Runs tasks until the pool is destroyed
+ */
+void WorkStealingPool::work(int index)
+{
+    function<void()> task;
+
+    while(true)
+    {
+        if(takeTask(index, task))
+        {
+            task();
+            task = nullptr;
+
+            if(--Pending == 0)
+            {
+                lock_guard<mutex> lock(IdleLock);
+                DoneCondition.notify_all();
+            }
+            continue;
+        }
+
+        unique_lock<mutex> lock(IdleLock);
+        if(Stop)
+        {
+            break;
+        }
+        IdleCondition.wait_for(lock, chrono::milliseconds(POOL_IDLE_WAIT_MS),
+                               [this]{ return Stop || Queued > 0; });
+    }
+}
+
+/* Own queue first (newest task), then the oldest task of another queue
+ */
+bool WorkStealingPool::takeTask(int index, function<void()> &task)
+{
+    if(Queued == 0)
+    {
+        return false;
+    }
+
+    {
+        taskqueue *own = Queues[index].get();
+        lock_guard<mutex> lock(own->lock);
+        if(!own->tasks.empty())
+        {
+            task = move(own->tasks.back());
+            own->tasks.pop_back();
+            Queued--;
+            return true;
+        }
+    }
+
+    for(size_t i = 1; i < Queues.size(); i++)
+    {
+        taskqueue *victim = Queues[(index + i) % Queues.size()].get();
+        lock_guard<mutex> lock(victim->lock);
+        if(!victim->tasks.empty())
+        {
+            task = move(victim->tasks.front());
+            victim->tasks.pop_front();
+            Queued--;
+            Stolen++;
+            return true;
+        }
+    }
+
+    return false;
+}
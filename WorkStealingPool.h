@@ -0,0 +1,141 @@
+/**
+ * @file:   WorkStealingPool.h
+ * @class:  WorkStealingPool
+ *
+ * @author: Sven Sperner, sillyconn@gmail.com
+ *
+ * @date:   17.10.2026
+ *
+ * @brief:  Thread pool with one task queue per worker
+ *          Idle workers steal from the queues of the others
+ *
+ * Copyright (c) 2026 All Rights Reserved
+ */
+
+
+#ifndef workstealingpool_
+#define workstealingpool_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+
+#define POOL_IDLE_WAIT_MS   1   // idle workers look for new tasks at least this often
+
+
+
+class WorkStealingPool
+{
+    public:
+        /**
+         * @name:   Work Stealing Pool
+         * @brief:  Work Stealing Pool Constructor
+         *
+         *  Starts the workers, each with its own task queue
+         *
+         * @param:  The number of workers, 0 for one per core
+         */
+        WorkStealingPool(int threads);
+
+        /**
+         * @name:   ~Work Stealing Pool
+         * @brief:  Work Stealing Pool Destructor
+         *
+         *  Waits for the queued tasks and joins the workers
+         */
+        ~WorkStealingPool();
+
+        /**
+         * @name:   Submit
+         * @brief:  Queues a task, the queues are filled round robin
+         *
+         * @param:  The task
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * @name:   Wait
+         * @brief:  Blocks until all submitted tasks are done
+         */
+        void wait();
+
+        /**
+         * @name:   Get Thread Count
+         * @brief:  Number of workers
+         *
+         * @return: The number of workers
+         */
+        int getThreadCount() const;
+
+        /**
+         * @name:   Get Stolen Tasks
+         * @brief:  Tasks run by another worker than the one they were queued for
+         *
+         * @return: The number of stolen tasks
+         */
+        uint64_t getStolenTasks() const;
+
+    private:
+        /**
+         * @name:   Task Queue
+         * @brief:  The owner pops from the back, thieves take from the front
+         */
+        struct taskqueue{
+            std::mutex lock;
+            std::deque< std::function<void()> > tasks;
+        };
+
+        std::vector< std::unique_ptr<taskqueue> > Queues;
+        std::vector<std::thread> Workers;
+
+        /**
+         * @name:   Counters
+         * @brief:  Tasks waiting in the queues, tasks not yet finished,
+         *          next queue for submit() and the stolen tasks
+         */
+        std::atomic<long> Queued;
+        std::atomic<long> Pending;
+        std::atomic<unsigned> NextQueue;
+        std::atomic<uint64_t> Stolen;
+
+        /**
+         * @name:   Stop
+         * @brief:  Set by the destructor to end the workers
+         */
+        std::atomic<bool> Stop;
+
+        /**
+         * @name:   Idle & Done Condition
+         * @brief:  Wakes idle workers on submit() and wait() on the last task
+         */
+        std::mutex IdleLock;
+        std::condition_variable IdleCondition;
+        std::condition_variable DoneCondition;
+
+        /**
+         * @name:   Work
+         * @brief:  Main loop of one worker
+         *
+         * @param:  The index of the worker
+         */
+        void work(int index);
+
+        /**
+         * @name:   Take Task
+         * @brief:  Takes a task from the own queue, else steals one
+         *
+         * @param:  The index of the worker
+         * @param:  Receives the task
+         * @return: When a task was found, 'true' is returned
+         */
+        bool takeTask(int index, std::function<void()> &task);
+};
+
+#endif
@@ -14,62 +14,80 @@
 
 
 #include <QApplication>
-#include <thread>
-#include <unistd.h>
+#include <errno.h>
+#include <iostream>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
 #include "UserInterface.h"
 #include "ControlSystem.h"
+#include "Headless.h"
 #include "Scheduler.h"
-#include "Pump.h"
 
 using namespace std;
 
 
 
 /**
- * Static function for the Control Systems watcher Thread
+ * Usage of the headless modes
  *
- * @brief Checks all System Components
- * @param Pointer to the representation of the ControlSystem object
- * @return EXIT_SUCCESS
+ * @brief Prints the arguments to stderr
+ * @param The name of the program
+ * @return EXIT_FAILURE
  */
-int watch(ControlSystem *ControlSystem)
+static int usage(const char *name)
 {
-    while(ControlSystem->getSchouldRun())
-    {
-        ControlSystem->checkBatteryStatus();
-        ControlSystem->checkOperationHours();
-        ControlSystem->checkPump();
-        ControlSystem->checkScheduler();
-        ControlSystem->checkTracer();
+    cerr << "Usage: " << name << " [-b cycles [patients [threads]] | -S sweepfile [threads] | -R trace\n"
+         << "            | -L [runs] | -I [seconds] | -P [seconds] | -A [steps] | -T [hours]]\n"
+         << "  without arguments: the pump with user interface\n"
+         << "  -b: throughput, with patients as a batch on threads (0: one per core)\n"
+         << "  -T 0: simulated up to the maximum operation time\n";
+    return EXIT_FAILURE;
+}
 
-        sleep(ControlSystem->getIntervalSec());
+/**
+ * Whole number argument
+ *
+ * @brief strtol with checks for trailing characters and the range
+ * @param The argument
+ * @param The smallest accepted value
+ * @param Receives the value
+ * @return true if the argument is a number from minimum to INT_MAX
+ */
+static bool parseNumber(const char *text, long minimum, long *value)
+{
+    char *end;
+    errno = 0;
+    long number = strtol(text, &end, 10);
+    if(errno != 0 || end == text || *end != '\0' || number < minimum || number > INT_MAX)
+    {
+        return false;
     }
 
-    return EXIT_SUCCESS;
+    *value = number;
+    return true;
 }
 
 /**
- * Static function for the Scheduler scheduling Thread
+ * Hours argument
  *
- * @brief Triggers the Pump for getting information from the Body
- *        Holds track of the Operation Time
- * @param Pointer to the representation of the Scheduler object
- * @return EXIT_SUCCESS
+ * @brief strtod with checks for trailing characters and the range
+ * @param The argument
+ * @param Receives the value
+ * @return true if the argument is a finite number of hours, not negative
  */
-int schedule(Scheduler *Scheduler)
+static bool parseHours(const char *text, double *value)
 {
-    while(Scheduler->getSchouldRun())
+    char *end;
+    errno = 0;
+    double number = strtod(text, &end);
+    if(errno != 0 || end == text || *end != '\0' || !(number >= 0 && number <= INT_MAX))
     {
-        if(Scheduler->getBatstatus() > 1)
-        {
-            Scheduler->triggerPump();
-        }
-        Scheduler->saveOperationTime();
-
-        sleep(Scheduler->getIntervalSec());
+        return false;
     }
 
-    return EXIT_SUCCESS;
+    *value = number;
+    return true;
 }
 
 
@@ -85,6 +103,100 @@ int main(int argc, char *argv[])
 {
     //Init battery
 
+    const char *mode = argc >= 2 ? argv[1] : "";
+    long cycles = 0, patients = 0, threads = 0;
+    double hours = 0;
+
+    // Headless benchmark: InsulinPump -b <cycles> [<patients> [<threads>]]
+    if(strcmp(mode, "-b") == 0)
+    {
+        if(argc < 3 || argc > 5 || !parseNumber(argv[2], 1, &cycles) ||
+           (argc >= 4 && !parseNumber(argv[3], 1, &patients)) ||
+           (argc >= 5 && !parseNumber(argv[4], 0, &threads)))
+        {
+            return usage(argv[0]);
+        }
+        if(argc >= 4)
+        {
+            return Headless::batch(cycles, patients, threads);
+        }
+        return Headless::benchmark(cycles);
+    }
+
+    // Parameter sweep: InsulinPump -S <sweepfile> [<threads>]
+    if(strcmp(mode, "-S") == 0)
+    {
+        if(argc < 3 || argc > 4 || (argc == 4 && !parseNumber(argv[3], 0, &threads)))
+        {
+            return usage(argv[0]);
+        }
+        return Headless::sweep(argv[2], threads);
+    }
+
+    // Replay without body: InsulinPump -R <trace>
+    if(strcmp(mode, "-R") == 0)
+    {
+        if(argc != 3)
+        {
+            return usage(argv[0]);
+        }
+        return Headless::replay(argv[2]);
+    }
+
+    // Scheduler wakeup latency: InsulinPump -L [<runs>]
+    if(strcmp(mode, "-L") == 0)
+    {
+        long runs = 100;
+        if(argc > 3 || (argc == 3 && !parseNumber(argv[2], 1, &runs)))
+        {
+            return usage(argv[0]);
+        }
+        return Headless::latency(runs);
+    }
+
+    // Idle wake-ups & CPU, tickless and not: InsulinPump -I [<seconds>]
+    if(strcmp(mode, "-I") == 0)
+    {
+        long seconds = IDLE_SECONDS;
+        if(argc > 3 || (argc == 3 && !parseNumber(argv[2], 1, &seconds)))
+        {
+            return usage(argv[0]);
+        }
+        return Headless::idle(seconds);
+    }
+
+    // Pump cycle jitter per real-time setting: InsulinPump -P [<seconds>]
+    if(strcmp(mode, "-P") == 0)
+    {
+        long seconds = REALTIME_SECONDS;
+        if(argc > 3 || (argc == 3 && !parseNumber(argv[2], 1, &seconds)))
+        {
+            return usage(argv[0]);
+        }
+        return Headless::realtime(seconds);
+    }
+
+    // Fixed against adaptive sampling: InsulinPump -A [<steps>]
+    if(strcmp(mode, "-A") == 0)
+    {
+        long steps = SAMPLING_STEPS;
+        if(argc > 3 || (argc == 3 && !parseNumber(argv[2], 1, &steps)))
+        {
+            return usage(argv[0]);
+        }
+        return Headless::sampling(steps);
+    }
+
+    // Full stack in simulated time: InsulinPump -T [<hours>]
+    if(strcmp(mode, "-T") == 0)
+    {
+        if(argc > 3 || (argc == 3 && !parseHours(argv[2], &hours)))
+        {
+            return usage(argv[0]);
+        }
+        return Headless::timelapse(hours);
+    }
+
     // Create User Interface
     QApplication application(argc, argv);
     UserInterface window;
@@ -93,16 +205,16 @@ int main(int argc, char *argv[])
     ControlSystem* TheControlSystem = new ControlSystem(&window);
     Scheduler* TheScheduler = TheControlSystem->getScheduler();
 
-    // Start Scheduler Thread
-    thread* Scheduler = new thread(schedule,TheScheduler);
-    TheScheduler->setThread(Scheduler);
-
-    // Start Controll System Thread
-    thread* Controller = new thread(watch,TheControlSystem);
-    Controller->detach();
+    // Start the pump cycle, persistence & health check jobs
+    TheScheduler->start();
 
     // Show UI
     window.show();
 
-    return application.exec();
+    int result = application.exec();
+
+    // Stops the jobs & saves the operation time, then deletes the stack
+    delete TheControlSystem;
+
+    return result;
 }